@@ -0,0 +1,228 @@
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "fmt.hh"
+#include "fmt_record.hh"
+#include "fmt_chrono.hh"
+#include "fmt_compress.hh"
+#include "fmt_table.hh"
+
+// Accumulates the output so the compiler can't discard the formatting work.
+struct Sink {
+  size_t bytes    = 0;
+  uint32_t digest = 0;
+  void write(const char *buf, size_t n) {
+    if (n > 0) {
+      bytes += n;
+      digest = digest * 31 + static_cast<uint8_t>(buf[n - 1]);
+    }
+  }
+};
+
+struct Stdout {
+  void write(const char *buf, size_t n) { fwrite(buf, 1, n, stdout); }
+};
+
+static Stdout out;
+static reisfmt::Fmt<Stdout> report(out);
+
+template <typename F>
+void bench(const char *name, size_t iterations, size_t bytes_per_iteration, F &&fn) {
+  Sink sink;
+  reisfmt::Fmt<Sink> fmt(sink);
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < iterations; ++i) {
+    fn(fmt);
+  }
+  auto end  = std::chrono::steady_clock::now();
+  auto ns   = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+  auto mbps = bytes_per_iteration * iterations * 1000 / static_cast<size_t>(ns ? ns : 1);
+  report.println("{:<40} {:>10} ns/op {:>6} MB/s  (digest {:#x})", name, ns / iterations, mbps, sink.digest);
+}
+
+// Reference escaper: one branch and one write per input character.
+template <reisfmt::Writeable T>
+void naive_escape(T &device, const char *str, size_t len) {
+  for (size_t i = 0; i < len; ++i) {
+    char c = str[i];
+    if (c == '"' || c == '\\') {
+      device.write("\\", 1);
+      device.write(&c, 1);
+    } else if (static_cast<uint8_t>(c) < 0x20) {
+      const char code[] = {'\\', 'u', '0', '0', "0123456789abcdef"[c >> 4], "0123456789abcdef"[c & 0xf]};
+      device.write(code, sizeof(code));
+    } else {
+      device.write(&c, 1);
+    }
+  }
+}
+
+static void bench_escape() {
+  std::string clean(256, 'a');
+  std::string dirty;
+  for (int i = 0; i < 256; ++i) {
+    dirty += (i % 16 == 0) ? '"' : static_cast<char>('a' + i % 26);
+  }
+
+  for (auto [name, text] : {std::pair{"clean", &clean}, std::pair{"dirty", &dirty}}) {
+    report.println("escape 256 bytes, {}:", name);
+    bench("  naive per-char", 100'000, text->size(),
+          [&](auto &fmt) { naive_escape(fmt.device, text->data(), text->size()); });
+    bench("  swar", 100'000, text->size(),
+          [&](auto &fmt) { reisfmt::escape::write_json(fmt.device, text->data(), text->size()); });
+  }
+
+  report.println("json line:");
+  bench("  json record", 100'000, 64, [](auto &fmt) {
+    fmt.println("{}", reisfmt::json(reisfmt::Field{"level", "info"}, reisfmt::Field{"msg", "link up on port"},
+                                    reisfmt::Field{"port", 3}, reisfmt::Field{"speed", 1000u}));
+  });
+}
+
+static void bench_timestamp() {
+  using namespace std::chrono;
+  sys_time<microseconds> tp = sys_days{year{2024} / 1 / 1} + 12h;
+
+  report.println("timestamp prefix:");
+  bench("  integer placeholders", 1'000'000, 16, [&](auto &fmt) {
+    tp += 1us;
+    auto time = tp - floor<days>(tp);
+    fmt.print("{:02}:{:02}:{:02}.{:06} ", duration_cast<hours>(time).count(), duration_cast<minutes>(time).count() % 60,
+              duration_cast<seconds>(time).count() % 60, time.count() % 1'000'000);
+  });
+  bench("  time_point, cached second", 1'000'000, 16, [&](auto &fmt) {
+    tp += 1us;
+    fmt.print("{:%T} ", tp);
+  });
+  bench("  time_point, new second per line", 1'000'000, 16, [&](auto &fmt) {
+    tp += 1s;
+    fmt.print("{:%T} ", tp);
+  });
+}
+
+#ifdef __SIZEOF_INT128__
+// Reference conversion: one 128 bits division per digit.
+template <size_t SIZE>
+size_t naive_to_str(std::array<char, SIZE> &buf, unsigned __int128 num) {
+  size_t tail = SIZE;
+  do {
+    buf[--tail] = num % 10 + '0';
+    num /= 10;
+  } while (num);
+  return SIZE - tail;
+}
+
+static void bench_int128() {
+  unsigned __int128 value = ~static_cast<unsigned __int128>(0) / 3;
+
+  report.println("128 bits decimal, 39 digits:");
+  bench("  per-digit 128 bits division", 1'000'000, 39, [&](auto &fmt) {
+    value ^= 1;
+    size_t len = naive_to_str(fmt.buf, value);
+    fmt.device.write(fmt.buf.data() + fmt.buf.size() - len, len);
+  });
+  bench("  10^19 chunks", 1'000'000, 39, [&](auto &fmt) {
+    value ^= 1;
+    fmt.print("{}", value);
+  });
+}
+#endif
+
+static constexpr std::array<const char *, 4> kLogFormats = {
+    "[{:>8}] I rx: channel {} packets={} bytes={} errors={}",
+    "[{:>8}] W tx: channel {} queue full, dropped {} frames",
+    "[{:>8}] I temp={} vbat={}mV state={}",
+    "[{:>8}] E dma: transfer {:#x} timed out after {}us",
+};
+
+template <typename F>
+static void sample_log(F &fmt, uint32_t line) {
+  uint32_t ts = line * 137;
+  switch (line % 7) {
+    case 0:
+    case 1:
+    case 2:
+      fmt.println(kLogFormats[0], ts, line % 4, 1000 + line, 64000 + line * 3, line % 11 == 0);
+      break;
+    case 3:
+      fmt.println(kLogFormats[1], ts, line % 4, line % 9);
+      break;
+    case 4:
+    case 5:
+      fmt.println(kLogFormats[2], ts, 40 + line % 3, 3300 - line % 50, line % 5 ? "RUN" : "IDLE");
+      break;
+    default:
+      fmt.println(kLogFormats[3], ts, 0x2000'0000 + line * 64, 500 + line % 100);
+      break;
+  }
+}
+
+template <size_t WINDOW>
+static void bench_compress_window(reisfmt::lz::Dictionary dictionary) {
+  constexpr uint32_t kLines = 100'000;
+  Sink raw;
+  reisfmt::Fmt<Sink> raw_fmt(raw);
+  for (uint32_t line = 0; line < kLines; ++line) {
+    sample_log(raw_fmt, line);
+  }
+
+  Sink wire;
+  reisfmt::Compressor<Sink, WINDOW> compressor(wire, dictionary);
+  reisfmt::Fmt<reisfmt::Compressor<Sink, WINDOW>> fmt(compressor);
+  auto start = std::chrono::steady_clock::now();
+  for (uint32_t line = 0; line < kLines; ++line) {
+    sample_log(fmt, line);
+  }
+  auto end = std::chrono::steady_clock::now();
+  auto ns  = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+
+  report.println("  window {:>4}, {:<13} {:>6} ns/line  ratio {:>3}%  ({} -> {} bytes)", WINDOW,
+                 dictionary.empty() ? "no dictionary" : "dictionary", ns / kLines, wire.bytes * 100 / raw.bytes,
+                 raw.bytes, wire.bytes);
+}
+
+static void bench_compress() {
+  report.println("compression of sample logs:");
+  bench("  uncompressed", 100'000, 50, [line = 0u](auto &fmt) mutable { sample_log(fmt, line++); });
+  std::string formats;
+  for (const char *format : kLogFormats) {
+    formats += format;
+    formats += '\n';
+  }
+  for (auto dictionary : {reisfmt::lz::Dictionary{}, reisfmt::lz::Dictionary{formats}}) {
+    bench_compress_window<256>(dictionary);
+    bench_compress_window<1024>(dictionary);
+    bench_compress_window<2048>(dictionary);
+  }
+}
+
+static void bench_table() {
+  constexpr size_t kRows    = 100'000;
+  constexpr const char *msg = "{:<10}{:>8}{:>8}{:#10x}";
+  std::vector<std::tuple<const char *, uint32_t, int32_t, uint32_t>> rows;
+  for (size_t i = 0; i < kRows; ++i) {
+    rows.emplace_back(i % 3 ? "rx" : "tx_dropped", i * 7, static_cast<int32_t>(i) - 5000, 0x2000'0000 + i * 64);
+  }
+
+  report.println("table of {} rows:", kRows);
+  bench("  println per row", 10, kRows * 36, [&](auto &fmt) {
+    for (auto [name, a, b, addr] : rows) {
+      fmt.println(msg, name, a, b, addr);
+    }
+  });
+  bench("  print_table", 10, kRows * 36, [&](auto &fmt) { reisfmt::print_table(fmt, msg, rows); });
+  bench("  print_table, auto width", 10, kRows * 36, [&](auto &fmt) { reisfmt::print_table(fmt, msg, rows, true); });
+}
+
+int main() {
+  bench_escape();
+  bench_timestamp();
+#ifdef __SIZEOF_INT128__
+  bench_int128();
+#endif
+  bench_compress();
+  bench_table();
+  return 0;
+}
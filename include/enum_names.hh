@@ -0,0 +1,182 @@
+
+#pragma once
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <stdint.h>
+#include <stddef.h>
+
+namespace reisfmt {
+
+// Specialize this struct to change the range of values probed for names, e.g. for enums with negative values:
+//   template <> struct EnumTraits<Errno> { static constexpr int min = -64; static constexpr int max = 0; };
+// Or to declare the names explicitly instead of deriving them from the compiler:
+//   template <> struct EnumTraits<Mode> {
+//     static constexpr std::array<std::pair<Mode, const char *>, 2> names = {{{Mode::Idle, "IDLE"}, ...}};
+//   };
+template <typename E>
+struct EnumTraits {
+  static constexpr int min = 0;
+  static constexpr int max = 127;
+};
+
+namespace enums {
+// Extracts the enumerator name from the signature, valid values look like `ns::Color::Red` while values with no
+// enumerator look like `(ns::Color)5`.
+template <auto V>
+constexpr std::string_view pretty_name() {
+  std::string_view name = __PRETTY_FUNCTION__;
+  size_t start          = name.find("V = ");
+  if (start == std::string_view::npos) {
+    return {};
+  }
+  start += 4;
+  name = name.substr(start, name.find_first_of(";]", start) - start);
+  if (name.empty() || name[0] == '(' || name[0] == '-' || (name[0] >= '0' && name[0] <= '9')) {
+    return {};
+  }
+  if (size_t scope = name.rfind("::"); scope != std::string_view::npos) {
+    name.remove_prefix(scope + 2);
+  }
+  return name;
+}
+
+template <typename E>
+concept HasNameTable = requires { EnumTraits<E>::names; };
+
+// Unscoped enums without a fixed underlying type only hold the values that fit in the bits of their enumerators,
+// casting other values is not a constant expression, e.g. `enum Color { Red, Green, Blue }` only holds [0, 3].
+template <typename E, int64_t Value>
+concept ValidValue = requires { typename std::integral_constant<E, static_cast<E>(Value)>; };
+
+// The values of an enum range are [-2^M, 2^M - 1] or [0, 2^M - 1], so the limits are narrowed to those forms until
+// they are valid.
+template <typename E, int Min>
+constexpr int valid_min() {
+  if constexpr (Min >= 0 || ValidValue<E, Min>) {
+    return Min;
+  } else {
+    return valid_min<E, -static_cast<int>(std::bit_floor(static_cast<unsigned>(-(Min + 1))))>();
+  }
+}
+
+template <typename E, int Max>
+constexpr int valid_max() {
+  if constexpr (Max <= 0 || ValidValue<E, Max>) {
+    return Max;
+  } else {
+    return valid_max<E, static_cast<int>(std::bit_floor(static_cast<unsigned>(Max))) - 1>();
+  }
+}
+
+// Converts `value` to a 64 bits integer of the signedness of its underlying type, so no value is narrowed.
+template <typename E>
+constexpr auto widen(E value) {
+  if constexpr (std::is_signed_v<std::underlying_type_t<E>>) {
+    return static_cast<int64_t>(value);
+  } else {
+    return static_cast<uint64_t>(value);
+  }
+}
+
+template <typename E>
+constexpr int64_t min() {
+  if constexpr (HasNameTable<E>) {
+    int64_t res = static_cast<int64_t>(widen(EnumTraits<E>::names[0].first));
+    for (auto [value, _] : EnumTraits<E>::names) {
+      res = std::min(res, static_cast<int64_t>(widen(value)));
+    }
+    return res;
+  } else {
+    return valid_min<E, EnumTraits<E>::min>();
+  }
+}
+
+template <typename E>
+constexpr int64_t max() {
+  if constexpr (HasNameTable<E>) {
+    int64_t res = static_cast<int64_t>(widen(EnumTraits<E>::names[0].first));
+    for (auto [value, _] : EnumTraits<E>::names) {
+      res = std::max(res, static_cast<int64_t>(widen(value)));
+    }
+    return res;
+  } else {
+    return valid_max<E, EnumTraits<E>::max>();
+  }
+}
+
+template <typename E, int64_t Value>
+constexpr std::string_view name() {
+  if constexpr (HasNameTable<E>) {
+    for (auto [value, str] : EnumTraits<E>::names) {
+      if (std::cmp_equal(widen(value), Value)) {
+        return str;
+      }
+    }
+    return {};
+  } else if constexpr (ValidValue<E, Value>) {
+    return pretty_name<static_cast<E>(Value)>();
+  } else {
+    return {};
+  }
+}
+
+// Dense table with the names of the values in [min, max], all names are packed in a single char array so only
+// the names themselves end up in the binary.
+template <typename E>
+struct Names {
+  static constexpr int64_t kMin  = min<E>();
+  static constexpr int64_t kMax  = max<E>();
+  static constexpr size_t kCount = kMax - kMin + 1;
+  static_assert(kCount <= 4096, "The enum range is too wide for a name table");
+
+  template <size_t... I>
+  static constexpr std::array<std::string_view, kCount> views(std::index_sequence<I...>) {
+    return {name<E, kMin + static_cast<int64_t>(I)>()...};
+  }
+  static constexpr auto kViews = views(std::make_index_sequence<kCount>{});
+
+  static constexpr size_t chars_size() {
+    size_t size = 0;
+    for (auto view : kViews) {
+      size += view.size();
+    }
+    return size;
+  }
+
+  using Offset = std::conditional_t<(chars_size() <= UINT16_MAX), uint16_t, uint32_t>;
+
+  static constexpr auto kChars = [] {
+    std::array<char, chars_size() + 1> chars{};
+    size_t pos = 0;
+    for (auto view : kViews) {
+      for (char c : view) {
+        chars[pos++] = c;
+      }
+    }
+    return chars;
+  }();
+
+  static constexpr auto kOffsets = [] {
+    std::array<Offset, kCount + 1> offsets{};
+    for (size_t i = 0; i < kCount; ++i) {
+      offsets[i + 1] = offsets[i] + kViews[i].size();
+    }
+    return offsets;
+  }();
+
+  // Returns an empty view if the value has no name.
+  static inline std::string_view get(E value) {
+    auto raw = widen(value);
+    if (std::cmp_less(raw, kMin) || std::cmp_greater(raw, kMax)) {
+      return {};
+    }
+    size_t index = static_cast<size_t>(static_cast<int64_t>(raw) - kMin);
+    return {kChars.data() + kOffsets[index], static_cast<size_t>(kOffsets[index + 1] - kOffsets[index])};
+  }
+};
+}  // namespace enums
+}  // namespace reisfmt
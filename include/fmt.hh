@@ -4,11 +4,13 @@
 #include <type_traits>
 #include <array>
 #include <string>
+#include <cstring>
 #include <stdint.h>
 #include <stddef.h>
 #include <algorithm>
 
 #include "to_string.hh"
+#include "enum_names.hh"
 #include "spec.hh"
 #include "writeable.hh"
 
@@ -27,22 +29,58 @@ concept Printable = requires(T t, Fmt<F> &fmt) {
   { t.print(fmt) } -> std::same_as<void>;
 };
 
+// Formatters that apply the width and alignment themselves declare `kAppliesWidth`, the output of the others is
+// padded by `Fmt`.
+template <typename T, typename U>
+concept AppliesWidth = requires { Formatter<T, U>::kAppliesWidth; };
+
+// Types that can be printed to any device, e.g. not a `Printable` that only takes a `Fmt<Uart>`.
+template <typename T, typename U>
+concept FormattableTo = requires(Fmt<T> &fmt, U &value) { Formatter<T, U>::print(fmt, value); };
+
+// Numbers are right aligned by default, `char` and `bool` are aligned like strings.
+template <typename U>
+constexpr bool kAlignRight = Integer<U> && !std::is_same_v<U, char> && !std::is_same_v<U, bool>;
+
+// Keeps the output that fits in a bounded buffer while counting its full size.
+struct BoundedBuffer {
+  char *data_;
+  size_t capacity_;
+  size_t size_ = 0;
+
+  void write(const char *buf, size_t n) {
+    if (size_ + n <= capacity_) {
+      std::memcpy(data_ + size_, buf, n);
+    }
+    size_ += n;
+  }
+};
+
 // This specialization allows types to implement `Printable` in order extend the print function.
 template <Writeable T, typename U>
-  requires std::is_class_v<U>
+  requires std::is_class_v<U> && Printable<U, T>
 struct Formatter<T, U> {
   static void print(Fmt<T> &fmt, U &obj) { obj.print(fmt); }
 };
 
 template <Writeable T, typename U>
-  requires std::integral<U>
+  requires Integer<U>
 struct Formatter<T, U> {
+  static constexpr bool kAppliesWidth = true;
+
   static void print(Fmt<T> &fmt, U num) {
     size_t len = 0;
     switch (fmt.spec.radix_) {
       case Spec::Radix::Bin:
         len = to_bit_str(fmt.buf, num);
         break;
+      case Spec::Radix::Oct:
+        len = to_oct_str(fmt.buf, num);
+        // The octal alternate form is a leading zero, which zero already has.
+        if (num == 0) {
+          fmt.spec.prefix_ = std::nullopt;
+        }
+        break;
       case Spec::Radix::Hex:
         len = to_hex_str(fmt.buf, num, fmt.spec.upper_case);
         break;
@@ -57,8 +95,30 @@ struct Formatter<T, U> {
   }
 };
 
+// Enums are printed by name, values with no name and integer types (`{:d}`, `{:x}`...) print the underlying value.
+template <Writeable T, typename U>
+  requires std::is_enum_v<U>
+struct Formatter<T, U> {
+  static constexpr bool kAppliesWidth = true;
+
+  static void print(Fmt<T> &fmt, U value) {
+    using Underlying = std::underlying_type_t<U>;
+    using Number     = std::conditional_t<std::is_same_v<Underlying, char>, int, Underlying>;
+    if (!fmt.spec.has_type_) {
+      if (auto name = enums::Names<U>::get(value); !name.empty()) {
+        StrIterator it(name.data(), name.size());
+        Formatter<T, StrIterator>::print(fmt, it);
+        return;
+      }
+    }
+    Formatter<T, Number>::print(fmt, static_cast<Number>(value));
+  }
+};
+
 template <Writeable T>
 struct Formatter<T, void *> {
+  static constexpr bool kAppliesWidth = true;
+
   static void print(Fmt<T> &fmt, void *pointer) {
     Formatter<T, uintptr_t>::print(fmt, reinterpret_cast<uintptr_t>(pointer));
   }
@@ -66,6 +126,8 @@ struct Formatter<T, void *> {
 
 template <Writeable T>
 struct Formatter<T, StrIterator> {
+  static constexpr bool kAppliesWidth = true;
+
   static inline void print(Fmt<T> &fmt, StrIterator &text) {
     auto &spec = fmt.spec;
     if (auto opt = spec.prefix_) {  // Is there a formating modifier(#)?
@@ -104,6 +166,8 @@ struct Formatter<T, bool> {
 
 template <Writeable T>
 struct Formatter<T, const char *> {
+  static constexpr bool kAppliesWidth = true;
+
   static inline void print(Fmt<T> &fmt, const char *str) {
     StrIterator text(str);
     Formatter<T, StrIterator>::print(fmt, text);
@@ -112,6 +176,8 @@ struct Formatter<T, const char *> {
 
 template <Writeable T>
 struct Formatter<T, std::basic_string<char>> {
+  static constexpr bool kAppliesWidth = true;
+
   static inline void print(Fmt<T> &fmt, const std::string &str) {
     StrIterator text(str.c_str(), str.length());
     Formatter<T, StrIterator>::print(fmt, text);
@@ -122,13 +188,20 @@ template <Writeable T>
 class Fmt {
  public:
   T &device;
-  std::array<char, sizeof(uint64_t) * 8> buf;
+  // Large enough for the binary representation of the widest integer plus the sign.
+  std::array<char, kMaxIntegerBits + 1> buf;
   StrIterator *it_;
   Spec spec;
 
   Fmt(T &device) : device(device) {};
 
  private:
+  inline void fill(char filler, int32_t count) {
+    while (count-- > 0) {
+      device.write(&filler, sizeof(filler));
+    }
+  }
+
   // Base case to stop the recursion.
   void format() {
     if (it_ && it_->peek()) {
@@ -157,12 +230,12 @@ class Fmt {
     } while (it_->size_ > 0);
 
     if (it_->size_ > 0) {  // Has the format guard been found?
-      spec.from_str(*it_, std::is_integral_v<U>);
+      spec.from_str(*it_, kAlignRight<U>);
 
       // The formatter can be extented for custom types, so the context is saved to allow the custom formatter to
       // recursively call this function.
       auto it = it_;
-      Formatter<T, U>::print(*this, first);
+      print_value(first);
       it_ = it;
 
       it_->find('}');
@@ -171,6 +244,49 @@ class Fmt {
   }
 
  public:
+  // Prints `value` with the current spec. The output of formatters that don't apply the width is rendered in `buf`
+  // to be padded, or measured first and then printed after the padding if it doesn't fit. Types that can only be
+  // printed to this device can't be measured, so they are printed without padding.
+  template <typename U>
+  void print_value(U &value) {
+    if constexpr (AppliesWidth<T, U> || !FormattableTo<BoundedBuffer, U>) {
+      Formatter<T, U>::print(*this, value);
+    } else {
+      if (spec.width_ <= 0) {
+        Formatter<T, U>::print(*this, value);
+        return;
+      }
+
+      BoundedBuffer bounded{buf.data(), buf.size()};
+      Fmt<BoundedBuffer> inner(bounded);
+      inner.it_         = it_;
+      inner.spec        = spec;
+      inner.spec.width_ = 0;
+      Formatter<BoundedBuffer, U>::print(inner, value);
+
+      spec.prefix_ = std::nullopt;
+      if (bounded.size_ <= bounded.capacity_) {
+        StrIterator text(buf.data(), bounded.size_);
+        Formatter<T, StrIterator>::print(*this, text);
+        return;
+      }
+
+      // The formatter may change the spec, so the padding is computed beforehand.
+      const char filler = spec.filler_;
+      int32_t padding   = std::max(0, spec.width_ - static_cast<int32_t>(bounded.size_));
+      int32_t left      = 0;
+      if (spec.align_ == Spec::Align::Right) {
+        left = padding;
+      } else if (spec.align_ == Spec::Align::Center) {
+        left = padding / 2;
+      }
+      fill(filler, left);
+      spec.width_ = 0;
+      Formatter<T, U>::print(*this, value);
+      fill(filler, padding - left);
+    }
+  }
+
   template <typename... Args>
   void println(const char *fmt, Args... args) {
     print(fmt, args...);
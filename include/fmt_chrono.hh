@@ -0,0 +1,322 @@
+
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <limits>
+#include <ratio>
+#include <type_traits>
+#include <stdint.h>
+#include <stddef.h>
+
+#include "fmt.hh"
+
+namespace reisfmt {
+namespace chrono {
+
+template <typename Period>
+constexpr const char *suffix() {
+  if constexpr (std::is_same_v<Period, std::nano>) {
+    return "ns";
+  } else if constexpr (std::is_same_v<Period, std::micro>) {
+    return "us";
+  } else if constexpr (std::is_same_v<Period, std::milli>) {
+    return "ms";
+  } else if constexpr (std::is_same_v<Period, std::ratio<1>>) {
+    return "s";
+  } else if constexpr (std::is_same_v<Period, std::ratio<60>>) {
+    return "min";
+  } else if constexpr (std::is_same_v<Period, std::ratio<3600>>) {
+    return "h";
+  } else if constexpr (std::is_same_v<Period, std::ratio<86400>>) {
+    return "d";
+  } else {
+    return "";
+  }
+}
+
+// Number of decimal digits used to print the sub-second part of a `Period` tick.
+// Periods that are not a power of ten are printed with microseconds precision.
+template <typename Period>
+constexpr int fraction_digits() {
+  if constexpr (Period::num >= Period::den) {
+    return 0;
+  } else {
+    intmax_t den = Period::den;
+    int digits   = 0;
+    for (; den % 10 == 0; den /= 10) {
+      digits++;
+    }
+    return den == 1 ? digits : 6;
+  }
+}
+
+constexpr intmax_t pow10(int exp) { return exp == 0 ? 1 : 10 * pow10(exp - 1); }
+
+template <typename Period>
+using FractionDuration = std::chrono::duration<uint64_t, std::ratio<1, pow10(fraction_digits<Period>())>>;
+
+// Broken down time, shared by the time point and the duration formatters.
+struct Fields {
+  int64_t year      = 1970;
+  uint32_t month    = 1;
+  uint32_t day      = 1;
+  uint64_t hours    = 0;
+  uint32_t minutes  = 0;
+  uint32_t seconds  = 0;
+  uint64_t fraction = 0;
+  int fraction_size = 0;
+  int64_t count     = 0;
+  const char *unit  = "";
+};
+
+// Renders a strftime-like spec into a fixed buffer, the output is truncated if it doesn't fit.
+// Supported conversions: %Y %m %d %F %H %M %S %T %Q %q %%. For time points %Q is the number of seconds since
+// the epoch.
+// %S includes the sub-second digits of the duration precision, their positions are recorded so they can be
+// updated without rendering the whole spec again.
+struct Text {
+  static constexpr size_t kMaxFractions = 4;
+
+  std::array<char, 64> buf_;
+  size_t size_ = 0;
+  std::array<uint8_t, kMaxFractions> fraction_at_;
+  size_t fractions_ = 0;
+  bool cacheable_   = true;  // Every fraction position was recorded.
+
+  inline void put(char c) {
+    if (size_ < buf_.size()) {
+      buf_[size_++] = c;
+    }
+  }
+
+  inline void put(const char *str) {
+    while (*str) {
+      put(*str++);
+    }
+  }
+
+  inline void put(uint64_t num, int width) {
+    std::array<char, 20> digits;
+    size_t len = to_str(digits, num);
+    for (int pad = width - static_cast<int>(len); pad > 0; --pad) {
+      put('0');
+    }
+    for (size_t i = 0; i < len; ++i) {
+      put(digits[i]);
+    }
+  }
+
+  inline void put_fraction(const Fields &fields) {
+    if (fields.fraction_size == 0) {
+      return;
+    }
+    put('.');
+    if (fractions_ < kMaxFractions && size_ + fields.fraction_size <= buf_.size()) {
+      fraction_at_[fractions_++] = size_;
+    } else {
+      cacheable_ = false;
+    }
+    put(fields.fraction, fields.fraction_size);
+  }
+
+  // Overwrites the sub-second digits recorded by the last `render`.
+  inline void update_fraction(uint64_t fraction, int digits) {
+    for (size_t i = 0; i < fractions_; ++i) {
+      uint64_t value = fraction;
+      for (int d = digits - 1; d >= 0; --d) {
+        buf_[fraction_at_[i] + d] = '0' + value % 10;
+        value /= 10;
+      }
+    }
+  }
+
+  inline void clear() {
+    size_      = 0;
+    fractions_ = 0;
+    cacheable_ = true;
+  }
+
+  // Appends the rendered `spec` to the buffer.
+  void render(StrIterator spec, const Fields &fields) {
+    while (auto opt = spec.next()) {
+      if (*opt != '%' || spec.size_ == 0) {
+        put(*opt);
+        continue;
+      }
+      switch (*spec.next()) {
+        case 'Y':
+          if (fields.year < 0) {
+            put('-');
+          }
+          put(static_cast<uint64_t>(fields.year < 0 ? -fields.year : fields.year), 4);
+          break;
+        case 'm':
+          put(fields.month, 2);
+          break;
+        case 'd':
+          put(fields.day, 2);
+          break;
+        case 'F':
+          render(StrIterator("%Y-%m-%d", 8), fields);
+          break;
+        case 'H':
+          put(fields.hours, 2);
+          break;
+        case 'M':
+          put(fields.minutes, 2);
+          break;
+        case 'S':
+          put(fields.seconds, 2);
+          put_fraction(fields);
+          break;
+        case 'T':
+          put(fields.hours, 2);
+          put(':');
+          put(fields.minutes, 2);
+          put(':');
+          put(fields.seconds, 2);
+          put_fraction(fields);
+          break;
+        case 'Q':
+          if (fields.count < 0) {
+            put('-');
+          }
+          put(static_cast<uint64_t>(fields.count < 0 ? -fields.count : fields.count), 0);
+          break;
+        case 'q':
+          put(fields.unit);
+          break;
+        case '%':
+          put('%');
+          break;
+        default:
+          put('%');
+          put(*(spec.head_ - 1));
+          break;
+      }
+    }
+  }
+};
+
+// Returns the chrono spec following the standard spec, e.g: `%H:%M` for `{:>10%H:%M}`.
+template <Writeable T>
+inline StrIterator spec_str(Fmt<T> &fmt, StrIterator default_spec) {
+  StrIterator &it = *fmt.it_;
+  size_t size     = 0;
+  while (size < it.size_ && it.head_[size] != '}') {
+    size++;
+  }
+  return size ? StrIterator(it.head_, size) : default_spec;
+}
+
+// Caches the rendered text of the last time point, so lines logged within the same second only re-render the
+// sub-second digits. The spec is copied, since the format string may be a reused buffer. Longer specs, or texts with
+// sub-second digits that couldn't be recorded, are not cached.
+struct Cache {
+  std::array<char, 32> spec_;
+  size_t spec_size_ = 0;
+  int64_t second_   = std::numeric_limits<int64_t>::min();
+  Text text_;
+
+  inline bool hit(StrIterator spec, int64_t second) const {
+    return second_ == second && spec_size_ == spec.size_ && std::memcmp(spec_.data(), spec.head_, spec.size_) == 0;
+  }
+
+  inline void store(StrIterator spec, int64_t second) {
+    if (spec.size_ <= spec_.size() && text_.cacheable_) {
+      std::memcpy(spec_.data(), spec.head_, spec.size_);
+      spec_size_ = spec.size_;
+      second_    = second;
+    } else {
+      second_ = std::numeric_limits<int64_t>::min();
+    }
+  }
+};
+}  // namespace chrono
+
+// The time point cache is kept per thread. On toolchains without thread local storage, define
+// REISFMT_NO_THREAD_LOCAL to use a single static cache, time points must then be printed from one thread at a time.
+#ifdef REISFMT_NO_THREAD_LOCAL
+#define REISFMT_THREAD_LOCAL
+#else
+#define REISFMT_THREAD_LOCAL thread_local
+#endif
+
+template <Writeable T, typename Rep, typename Period>
+struct Formatter<T, std::chrono::duration<Rep, Period>> {
+  static_assert(Integer<Rep>, "Only durations with an integer representation are supported");
+  static constexpr bool kAppliesWidth = true;
+
+  static inline void print(Fmt<T> &fmt, std::chrono::duration<Rep, Period> dur) {
+    using namespace std::chrono;
+    using Fraction = chrono::FractionDuration<Period>;
+
+    auto abs  = dur < dur.zero() ? -dur : dur;
+    auto secs = duration_cast<seconds>(abs);
+
+    chrono::Fields fields;
+    fields.count         = abs.count();
+    fields.unit          = chrono::suffix<Period>();
+    fields.hours         = duration_cast<hours>(secs).count();
+    fields.minutes       = duration_cast<minutes>(secs).count() % 60;
+    fields.seconds       = secs.count() % 60;
+    fields.fraction      = duration_cast<Fraction>(abs - secs).count();
+    fields.fraction_size = chrono::fraction_digits<Period>();
+
+    chrono::Text text;
+    if (dur < dur.zero()) {
+      text.put('-');
+    }
+    text.render(chrono::spec_str(fmt, StrIterator("%Q%q", 4)), fields);
+    StrIterator it(text.buf_.data(), text.size_);
+    Formatter<T, StrIterator>::print(fmt, it);
+  }
+};
+
+// Time points are printed in UTC, counting from the clock epoch as if it was 1970-01-01.
+template <Writeable T, typename Clock, typename Dur>
+struct Formatter<T, std::chrono::time_point<Clock, Dur>> {
+  static constexpr bool kAppliesWidth = true;
+
+  static inline void print(Fmt<T> &fmt, std::chrono::time_point<Clock, Dur> tp) {
+    using namespace std::chrono;
+    using Fraction            = chrono::FractionDuration<typename Dur::period>;
+    constexpr int kFracDigits = chrono::fraction_digits<typename Dur::period>();
+
+    static REISFMT_THREAD_LOCAL chrono::Cache cache;
+
+    StrIterator spec = chrono::spec_str(fmt, StrIterator("%F %T", 5));
+    auto since       = tp.time_since_epoch();
+    auto secs        = floor<seconds>(since);
+    uint64_t frac    = duration_cast<Fraction>(since - secs).count();
+
+    if (!cache.hit(spec, secs.count())) {
+      auto date = floor<days>(secs);
+      year_month_day ymd{sys_days{date}};
+      auto time = secs - date;
+
+      chrono::Fields fields;
+      fields.year          = static_cast<int>(ymd.year());
+      fields.month         = static_cast<unsigned>(ymd.month());
+      fields.day           = static_cast<unsigned>(ymd.day());
+      fields.hours         = duration_cast<hours>(time).count();
+      fields.minutes       = duration_cast<minutes>(time).count() % 60;
+      fields.seconds       = time.count() % 60;
+      fields.fraction      = frac;
+      fields.fraction_size = kFracDigits;
+      fields.count         = secs.count();
+      fields.unit          = "s";
+
+      cache.text_.clear();
+      cache.text_.render(spec, fields);
+      cache.store(spec, secs.count());
+    } else {
+      cache.text_.update_fraction(frac, kFracDigits);
+    }
+
+    StrIterator it(cache.text_.buf_.data(), cache.text_.size_);
+    Formatter<T, StrIterator>::print(fmt, it);
+  }
+};
+}  // namespace reisfmt
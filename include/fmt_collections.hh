@@ -3,6 +3,7 @@
 #include <concepts>
 #include <array>
 #include <span>
+#include <vector>
 #include "writeable.hh"
 
 namespace reisfmt {
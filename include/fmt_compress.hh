@@ -0,0 +1,230 @@
+
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <string_view>
+#include <stdint.h>
+#include <stddef.h>
+
+#include "writeable.hh"
+
+namespace reisfmt {
+
+// Byte oriented LZ77 stream, tuned for small windows of repetitive text:
+//   00LLLLLL [L + 1 literal bytes]
+//   01LLLLOO OOOOOOOO    copy L + 3 bytes from the dictionary at offset O.
+//   1LLLLOOO OOOOOOOO    copy L + 3 bytes from `O + 1` bytes back.
+// Both sides can share a static dictionary, e.g. the format strings of the application. Unlike the window it's never
+// overwritten, so the text it holds still compresses long after it was last logged. Only its first kMaxDictionary
+// bytes are used.
+namespace lz {
+constexpr size_t kMinMatch      = 3;
+constexpr size_t kMaxMatch      = kMinMatch + 0xf;
+constexpr size_t kMaxLiterals   = 0x40;
+constexpr size_t kMaxWindow     = 0x800;
+constexpr size_t kMaxDictionary = 0x400;
+
+using Dictionary = std::string_view;
+}  // namespace lz
+
+// Writeable adapter that compresses the stream before forwarding it to `device`.
+// The pending data is encoded on every new line or on `flush`, so each line reaches the device as soon as it's
+// complete. The memory used is fixed: WINDOW bytes of history plus about 1.1 KiB of state. The dictionary is only
+// referenced, so it can stay in flash.
+template <Writeable T, size_t WINDOW = 1024>
+class Compressor {
+  static_assert(WINDOW <= lz::kMaxWindow && (WINDOW & (WINDOW - 1)) == 0, "WINDOW must be a power of 2 <= 2048");
+  static constexpr size_t kHashBits = 8;
+
+  T &device_;
+  std::array<char, WINDOW> window_{};
+  std::array<uint16_t, 1 << kHashBits> table_{};
+  lz::Dictionary dictionary_;
+  std::array<uint16_t, 1 << kHashBits> dictionary_table_{};  // Offset + 1 in the dictionary, 0 for none.
+  std::array<char, lz::kMaxMatch> lookahead_;
+  size_t lookahead_size_ = 0;
+  std::array<char, lz::kMaxLiterals + 1> literals_;
+  size_t literals_size_ = 0;
+  uint32_t pos_         = 0;
+
+ public:
+  Compressor(T &device, lz::Dictionary dictionary = {})
+      : device_(device), dictionary_(dictionary.substr(0, lz::kMaxDictionary)) {
+    for (size_t i = 0; i + lz::kMinMatch <= dictionary_.size(); ++i) {
+      auto &entry = dictionary_table_[hash(dictionary_.data() + i)];
+      if (entry == 0) {
+        entry = static_cast<uint16_t>(i + 1);
+      }
+    }
+  }
+
+  void write(const char *buf, size_t n) {
+    while (n--) {
+      char c                        = *buf++;
+      lookahead_[lookahead_size_++] = c;
+      if (lookahead_size_ == lookahead_.size()) {
+        step();
+      }
+      if (c == '\n') {
+        flush();
+      }
+    }
+  }
+
+  void flush() {
+    while (lookahead_size_ > 0) {
+      step();
+    }
+    flush_literals();
+  }
+
+ private:
+  static inline uint32_t hash(const char *str) {
+    uint32_t key =
+        static_cast<uint8_t>(str[0]) | static_cast<uint8_t>(str[1]) << 8 | static_cast<uint8_t>(str[2]) << 16;
+    return (key * 2654435761u) >> (32 - kHashBits);
+  }
+
+  // Appends `count` bytes from `str` to the history, the bytes after them are needed to index the position.
+  inline void push(const char *str, size_t count, size_t available) {
+    for (size_t i = 0; i < count; ++i) {
+      if (available - i >= lz::kMinMatch) {
+        table_[hash(str + i)] = static_cast<uint16_t>(pos_);
+      }
+      window_[pos_ & (WINDOW - 1)] = str[i];
+      pos_++;
+    }
+  }
+
+  // Returns the length of the match at `dist` bytes back.
+  inline size_t match_length(uint32_t dist) {
+    size_t max = std::min({lookahead_size_, static_cast<size_t>(dist), lz::kMaxMatch});
+    size_t len = 0;
+    while (len < max && window_[(pos_ - dist + len) & (WINDOW - 1)] == lookahead_[len]) {
+      len++;
+    }
+    return len;
+  }
+
+  // Returns the length of the match at `offset` in the dictionary.
+  inline size_t dictionary_match_length(size_t offset) {
+    size_t max = std::min({lookahead_size_, dictionary_.size() - offset, lz::kMaxMatch});
+    size_t len = 0;
+    while (len < max && dictionary_[offset + len] == lookahead_[len]) {
+      len++;
+    }
+    return len;
+  }
+
+  inline void step() {
+    size_t len = 1;
+    if (lookahead_size_ >= lz::kMinMatch) {
+      uint32_t key  = hash(lookahead_.data());
+      uint32_t dist = static_cast<uint16_t>(pos_ - table_[key]);
+      if (dist > 0 && dist <= WINDOW && dist <= pos_) {
+        len = match_length(dist);
+      }
+      size_t offset         = dictionary_table_[key];
+      size_t dictionary_len = offset > 0 ? dictionary_match_length(--offset) : 0;
+
+      if (dictionary_len >= lz::kMinMatch && dictionary_len > len) {
+        len = dictionary_len;
+        flush_literals();
+        const char token[] = {static_cast<char>(0x40 | (len - lz::kMinMatch) << 2 | offset >> 8),
+                              static_cast<char>(offset & 0xff)};
+        device_.write(token, sizeof(token));
+      } else if (len >= lz::kMinMatch) {
+        flush_literals();
+        const char token[] = {static_cast<char>(0x80 | (len - lz::kMinMatch) << 3 | (dist - 1) >> 8),
+                              static_cast<char>((dist - 1) & 0xff)};
+        device_.write(token, sizeof(token));
+      } else {
+        len = 1;
+      }
+    }
+
+    if (len == 1) {
+      literals_[1 + literals_size_++] = lookahead_[0];
+      if (literals_size_ == lz::kMaxLiterals) {
+        flush_literals();
+      }
+    }
+
+    push(lookahead_.data(), len, lookahead_size_);
+    lookahead_size_ -= len;
+    std::memmove(lookahead_.data(), lookahead_.data() + len, lookahead_size_);
+  }
+
+  inline void flush_literals() {
+    if (literals_size_ > 0) {
+      literals_[0] = static_cast<char>(literals_size_ - 1);
+      device_.write(literals_.data(), literals_size_ + 1);
+      literals_size_ = 0;
+    }
+  }
+};
+
+// Writeable adapter that decodes the `Compressor` stream into `device`, it must be given the same dictionary.
+// The encoded stream can be split at any byte.
+template <Writeable T>
+class Decompressor {
+  T &device_;
+  std::array<char, lz::kMaxWindow> window_{};
+  lz::Dictionary dictionary_;
+  uint32_t pos_    = 0;
+  size_t literals_ = 0;
+  int16_t match_   = -1;
+
+ public:
+  Decompressor(T &device, lz::Dictionary dictionary = {})
+      : device_(device), dictionary_(dictionary.substr(0, lz::kMaxDictionary)) {}
+
+  void write(const char *buf, size_t n) {
+    while (n > 0) {
+      if (literals_ > 0) {
+        size_t run = std::min(literals_, n);
+        device_.write(buf, run);
+        for (size_t i = 0; i < run; ++i) {
+          window_[pos_++ & (window_.size() - 1)] = buf[i];
+        }
+        literals_ -= run;
+        buf += run;
+        n -= run;
+      } else if (match_ >= 0) {
+        uint8_t token = static_cast<uint8_t>(match_);
+        std::array<char, lz::kMaxMatch> copy;
+        size_t len = 0;
+        if (token & 0x80) {
+          len           = ((token >> 3) & 0xf) + lz::kMinMatch;
+          uint32_t dist = ((token & 0x7) << 8 | static_cast<uint8_t>(*buf)) + 1;
+          for (size_t i = 0; i < len; ++i) {
+            copy[i]                                = window_[(pos_ - dist) & (window_.size() - 1)];
+            window_[pos_++ & (window_.size() - 1)] = copy[i];
+          }
+        } else {
+          // Offsets out of the dictionary can only come from a corrupted stream, they copy nothing.
+          size_t offset = std::min<size_t>((token & 0x3) << 8 | static_cast<uint8_t>(*buf), dictionary_.size());
+          len           = std::min(((token >> 2) & 0xf) + lz::kMinMatch, dictionary_.size() - offset);
+          for (size_t i = 0; i < len; ++i) {
+            copy[i]                                = dictionary_[offset + i];
+            window_[pos_++ & (window_.size() - 1)] = copy[i];
+          }
+        }
+        device_.write(copy.data(), len);
+        match_ = -1;
+        buf++;
+        n--;
+      } else {
+        uint8_t token = static_cast<uint8_t>(*buf++);
+        n--;
+        if (token & 0xc0) {
+          match_ = token;
+        } else {
+          literals_ = token + 1;
+        }
+      }
+    }
+  }
+};
+}  // namespace reisfmt
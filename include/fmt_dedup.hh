@@ -0,0 +1,119 @@
+
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <stdint.h>
+#include <stddef.h>
+
+#include "to_string.hh"
+#include "writeable.hh"
+
+namespace reisfmt {
+
+// Writeable adapter that collapses consecutive identical lines into a single
+// "previous message repeated N times" line. Lines are buffered until their end in a fixed buffer of SIZE bytes and
+// compared by length and by a hash computed as the fragments arrive. Longer lines are forwarded as they arrive and
+// are never suppressed.
+// The summary is emitted when a different line arrives, or once `timeout` has passed since the first repetition,
+// either on the next repetition or on `poll`. `Clock` only needs a static `now()`, so a tick counter can be used on
+// targets without std::chrono clocks.
+template <Writeable T, size_t SIZE = 256, typename Clock = std::chrono::steady_clock>
+class Dedup {
+  static constexpr uint64_t kFnvOffset = 0xcbf29ce484222325ull;
+  static constexpr uint64_t kFnvPrime  = 0x100000001b3ull;
+
+  T &device_;
+  typename Clock::duration timeout_;
+  std::array<char, SIZE> buf_;
+  size_t size_        = 0;
+  bool forwarded_     = false;  // The current line was already written to the device.
+  uint64_t hash_      = kFnvOffset;
+  uint64_t last_hash_ = 0;
+  size_t last_size_   = 0;
+  bool has_last_      = false;
+  uint32_t repeats_   = 0;
+  typename Clock::time_point first_repeat_{};
+
+ public:
+  Dedup(T &device, typename Clock::duration timeout = std::chrono::seconds(1)) : device_(device), timeout_(timeout) {}
+
+  void write(const char *buf, size_t n) {
+    while (n > 0) {
+      auto end   = static_cast<const char *>(std::memchr(buf, '\n', n));
+      size_t run = end ? end - buf + 1 : n;
+      append(buf, run);
+      if (end) {
+        end_line();
+      }
+      buf += run;
+      n -= run;
+    }
+  }
+
+  // Emits the summary once the timeout has expired, call it periodically when the lines may stop arriving.
+  void poll() {
+    if (repeats_ > 0 && Clock::now() - first_repeat_ >= timeout_) {
+      flush_repeats();
+    }
+  }
+
+  // Emits the pending summary and the incomplete line, if any.
+  void flush() {
+    flush_repeats();
+    forward();
+  }
+
+ private:
+  inline void append(const char *buf, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+      hash_ = (hash_ ^ static_cast<uint8_t>(buf[i])) * kFnvPrime;
+    }
+    if (!forwarded_ && size_ + n <= SIZE) {
+      std::memcpy(buf_.data() + size_, buf, n);
+    } else {
+      flush();
+      forwarded_ = true;
+      device_.write(buf, n);
+    }
+    size_ += n;
+  }
+
+  inline void end_line() {
+    if (!forwarded_ && has_last_ && hash_ == last_hash_ && size_ == last_size_) {
+      auto now = Clock::now();
+      if (repeats_++ == 0) {
+        first_repeat_ = now;
+      } else if (now - first_repeat_ >= timeout_) {
+        flush_repeats();
+      }
+    } else {
+      flush();
+      last_hash_ = hash_;
+      last_size_ = size_;
+      has_last_  = true;
+    }
+    size_      = 0;
+    hash_      = kFnvOffset;
+    forwarded_ = false;
+  }
+
+  inline void forward() {
+    if (!forwarded_ && size_ > 0) {
+      device_.write(buf_.data(), size_);
+      forwarded_ = true;
+    }
+  }
+
+  inline void flush_repeats() {
+    if (repeats_ > 0) {
+      std::array<char, 10> digits;
+      size_t len = to_str(digits, repeats_);
+      device_.write("previous message repeated ", 26);
+      device_.write(digits.data(), len);
+      device_.write(repeats_ == 1 ? " time\r\n" : " times\r\n", repeats_ == 1 ? 7 : 8);
+      repeats_ = 0;
+    }
+  }
+};
+}  // namespace reisfmt
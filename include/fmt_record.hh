@@ -0,0 +1,274 @@
+
+#pragma once
+#include <concepts>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <stdint.h>
+#include <stddef.h>
+
+#include "fmt.hh"
+
+namespace reisfmt {
+
+namespace escape {
+// Broadcast a byte to every lane of a 64 bits word.
+constexpr uint64_t broadcast(uint8_t c) { return 0x0101010101010101ull * c; }
+
+// Non-zero if any byte of `word` is zero.
+constexpr uint64_t has_zero(uint64_t word) {
+  return (word - broadcast(0x01)) & ~word & broadcast(0x80);
+}
+
+// Non-zero if any byte of `word` is lower than `n`, with n <= 128.
+constexpr uint64_t has_less(uint64_t word, uint8_t n) {
+  return (word - broadcast(n)) & ~word & broadcast(0x80);
+}
+
+template <char... Special>
+constexpr bool is_special(char c) {
+  return static_cast<uint8_t>(c) < 0x20 || ((c == Special) || ...);
+}
+
+// Returns the index of the first control character or `Special` byte in `str`, or `len` if there is none.
+// The string is scanned 8 bytes at a time so clean runs cost one load and a few ALU operations per word.
+template <char... Special>
+inline size_t find_special(const char *str, size_t len) {
+  size_t i = 0;
+  for (; i + sizeof(uint64_t) <= len; i += sizeof(uint64_t)) {
+    uint64_t word;
+    std::memcpy(&word, str + i, sizeof(word));
+    if (has_less(word, 0x20) | (has_zero(word ^ broadcast(Special)) | ...)) {
+      break;
+    }
+  }
+
+  for (; i < len; ++i) {
+    if (is_special<Special...>(str[i])) {
+      return i;
+    }
+  }
+  return len;
+}
+
+// Writes `str` with the JSON string escapes applied, without the surrounding quotes.
+template <Writeable T>
+inline void write_json(T &device, const char *str, size_t len) {
+  while (len > 0) {
+    size_t run = find_special<'"', '\\'>(str, len);
+    if (run > 0) {
+      device.write(str, run);
+    }
+    if (run == len) {
+      return;
+    }
+
+    char c = str[run];
+    switch (c) {
+      case '"':
+        device.write("\\\"", 2);
+        break;
+      case '\\':
+        device.write("\\\\", 2);
+        break;
+      case '\n':
+        device.write("\\n", 2);
+        break;
+      case '\r':
+        device.write("\\r", 2);
+        break;
+      case '\t':
+        device.write("\\t", 2);
+        break;
+      case '\b':
+        device.write("\\b", 2);
+        break;
+      case '\f':
+        device.write("\\f", 2);
+        break;
+      default: {
+        constexpr const char *digits = "0123456789abcdef";
+        const char code[]            = {'\\', 'u', '0', '0', digits[(c >> 4) & 0xf], digits[c & 0xf]};
+        device.write(code, sizeof(code));
+        break;
+      }
+    }
+    str += run + 1;
+    len -= run + 1;
+  }
+}
+
+// Writeable adapter that applies the JSON string escapes to the output written to `device`.
+template <Writeable T>
+struct JsonWriter {
+  T &device_;
+  void write(const char *buf, size_t n) { write_json(device_, buf, n); }
+};
+
+// Writeable adapter that only records the size of the output and whether it has any control or `Special` byte.
+template <char... Special>
+struct Detector {
+  size_t size_  = 0;
+  bool special_ = false;
+  void write(const char *buf, size_t n) {
+    size_ += n;
+    special_ = special_ || find_special<Special...>(buf, n) != n;
+  }
+};
+}  // namespace escape
+
+template <typename V>
+struct Field {
+  const char *key_;
+  V value_;
+};
+
+template <typename V>
+Field(const char *, V) -> Field<V>;
+
+// Encodes records as JSON objects: {"key":value,...}
+struct Json {
+  template <Writeable T>
+  static inline void begin(T &device) {
+    device.write("{", 1);
+  }
+
+  template <Writeable T>
+  static inline void end(T &device) {
+    device.write("}", 1);
+  }
+
+  template <Writeable T>
+  static inline void key(T &device, const char *key, bool first) {
+    if (!first) {
+      device.write(",", 1);
+    }
+    device.write("\"", 1);
+    escape::write_json(device, key, std::strlen(key));
+    device.write("\":", 2);
+  }
+
+  template <Writeable T>
+  static inline void string(T &device, const char *str, size_t len) {
+    device.write("\"", 1);
+    escape::write_json(device, str, len);
+    device.write("\"", 1);
+  }
+
+  // Writes as a string the output of `print`, called with the Writeable to print to.
+  template <Writeable T, typename Print>
+  static inline void value(T &device, Print print) {
+    device.write("\"", 1);
+    escape::JsonWriter<T> writer{device};
+    print(writer);
+    device.write("\"", 1);
+  }
+
+  template <Writeable T>
+  static inline void null(T &device) {
+    device.write("null", 4);
+  }
+};
+
+// Encodes records as logfmt: key=value key="quoted value"...
+struct Logfmt {
+  template <Writeable T>
+  static inline void begin(T &) {}
+
+  template <Writeable T>
+  static inline void end(T &) {}
+
+  template <Writeable T>
+  static inline void key(T &device, const char *key, bool first) {
+    if (!first) {
+      device.write(" ", 1);
+    }
+    device.write(key, std::strlen(key));
+    device.write("=", 1);
+  }
+
+  template <Writeable T>
+  static inline void string(T &device, const char *str, size_t len) {
+    // Values are only quoted when they would otherwise be ambiguous.
+    if (len > 0 && escape::find_special<' ', '=', '"', '\\'>(str, len) == len) {
+      device.write(str, len);
+      return;
+    }
+    Json::string(device, str, len);
+  }
+
+  // Same as `string` for the output of `print`, which is called twice: to check the output and to write it.
+  template <Writeable T, typename Print>
+  static inline void value(T &device, Print print) {
+    escape::Detector<' ', '=', '"', '\\'> detector;
+    print(detector);
+    if (detector.size_ > 0 && !detector.special_) {
+      print(device);
+      return;
+    }
+    Json::value(device, print);
+  }
+
+  template <Writeable T>
+  static inline void null(T &) {}
+};
+
+template <typename Encoder, typename... V>
+struct Record {
+  std::tuple<Field<V>...> fields_;
+
+  template <typename T>
+  inline void print(Fmt<T> &fmt) {
+    Encoder::begin(fmt.device);
+    std::apply([&](auto &...fields) {
+      bool first = true;
+      ((encode(fmt, fields, first), first = false), ...);
+    }, fields_);
+    Encoder::end(fmt.device);
+  }
+
+ private:
+  template <typename T, typename U>
+  static inline void encode(Fmt<T> &fmt, Field<U> &field, bool first) {
+    Encoder::key(fmt.device, field.key_, first);
+    auto &value = field.value_;
+    if constexpr (std::is_same_v<U, bool>) {
+      value ? fmt.device.write("true", 4) : fmt.device.write("false", 5);
+    } else if constexpr (std::is_same_v<U, char>) {
+      Encoder::string(fmt.device, &value, 1);
+    } else if constexpr (Integer<U>) {
+      size_t len = to_str(fmt.buf, value);
+      fmt.device.write(fmt.buf.data(), len);
+    } else if constexpr (std::is_same_v<U, std::nullptr_t>) {
+      Encoder::null(fmt.device);
+    } else if constexpr (std::is_convertible_v<U, const char *>) {
+      const char *str = value;
+      Encoder::string(fmt.device, str, str ? std::strlen(str) : 0);
+    } else if constexpr (std::is_same_v<U, std::string> || std::is_same_v<U, std::string_view>) {
+      Encoder::string(fmt.device, value.data(), value.size());
+    } else if constexpr (std::is_same_v<U, StrIterator>) {
+      Encoder::string(fmt.device, value.head_, value.size_);
+    } else {
+      // Other types are rendered by their formatter with the default spec and encoded as strings.
+      Encoder::value(fmt.device, [&value]<Writeable W>(W &device) {
+        StrIterator spec("", size_t(0));
+        Fmt<W> inner(device);
+        inner.it_ = &spec;
+        Formatter<W, U>::print(inner, value);
+      });
+    }
+  }
+};
+
+template <typename... V>
+inline Record<Json, V...> json(Field<V>... fields) {
+  return Record<Json, V...>{{fields...}};
+}
+
+template <typename... V>
+inline Record<Logfmt, V...> logfmt(Field<V>... fields) {
+  return Record<Logfmt, V...>{{fields...}};
+}
+}  // namespace reisfmt
@@ -0,0 +1,117 @@
+
+#pragma once
+#include <algorithm>
+#include <array>
+#include <span>
+#include <string_view>
+#include <utility>
+#include <stdint.h>
+#include <stddef.h>
+
+#include "fmt.hh"
+
+namespace reisfmt {
+
+struct BitField {
+  const char *name;
+  uint8_t offset;
+  uint8_t width;
+  // Optional names of the field values, indexed by value. Values without a name are printed as numbers.
+  std::span<const char *const> names = {};
+  Spec::Radix radix                  = Spec::Radix::Dec;
+};
+
+// Decodes a register value using a descriptor declared at compile time:
+//   struct Ctrl {
+//     static constexpr const char *name = "CTRL";
+//     static constexpr std::array<reisfmt::BitField, 2> fields = {{{"EN", 0, 1}, {"MODE", 1, 2, mode_names}}};
+//   };
+//   fmt.println("{}", reisfmt::Register<Ctrl>{0x8003}); // CTRL=0x8003 {EN=1, MODE=RUN}
+// The labels, masks and shifts are constants, at runtime only the fields are extracted and converted.
+// The register type must be unsigned, so the fields are extracted with logical shifts.
+template <typename Desc, typename U = uint32_t>
+  requires(Integer<U> && !is_signed_integer<U>())
+struct Register {
+  U value_;
+
+  template <typename T>
+  inline void print(Fmt<T> &fmt) {
+    static constexpr auto kName = label<Desc::name, "=0x">();
+    fmt.device.write(kName.data(), kName.size());
+    size_t len = to_hex_str(fmt.buf, value_);
+    fmt.device.write(fmt.buf.data(), len);
+    fmt.device.write(" {", 2);
+    [&]<size_t... I>(std::index_sequence<I...>) {
+      (print_field<I>(fmt), ...);
+    }(std::make_index_sequence<Desc::fields.size()>{});
+    fmt.device.write("}", 1);
+  }
+
+ private:
+  template <size_t N>
+  struct Literal {
+    char str[N];
+    constexpr Literal(const char (&s)[N]) { std::copy_n(s, N, str); }
+  };
+
+  // Concatenates `prefix`, `name` and `suffix` at compile time.
+  template <const char *const &Name, Literal Suffix, Literal Prefix = "">
+  static constexpr auto label() {
+    constexpr std::string_view name(Name);
+    std::array<char, sizeof(Prefix.str) - 1 + name.size() + sizeof(Suffix.str) - 1> res{};
+    auto it = std::copy_n(Prefix.str, sizeof(Prefix.str) - 1, res.begin());
+    it      = std::copy_n(name.data(), name.size(), it);
+    std::copy_n(Suffix.str, sizeof(Suffix.str) - 1, it);
+    return res;
+  }
+
+  template <size_t I>
+  static constexpr const char *field_name = Desc::fields[I].name;
+
+  template <size_t I, typename T>
+  inline void print_field(Fmt<T> &fmt) {
+    static constexpr BitField kField = Desc::fields[I];
+    static_assert(kField.width > 0 && kField.offset + kField.width <= sizeof(U) * 8, "Field out of the register");
+    static constexpr U kMask = kField.width == sizeof(U) * 8 ? ~U(0) : static_cast<U>((U(1) << kField.width) - 1);
+    static constexpr auto kLabel = [] {
+      if constexpr (I == 0) {
+        return label<field_name<I>, "=">();
+      } else {
+        return label<field_name<I>, "=", ", ">();
+      }
+    }();
+
+    fmt.device.write(kLabel.data(), kLabel.size());
+    U field = (value_ >> kField.offset) & kMask;
+
+    if constexpr (!kField.names.empty()) {
+      if (field < kField.names.size() && kField.names[field] != nullptr) {
+        const char *name = kField.names[field];
+        fmt.device.write(name, std::string_view(name).size());
+        return;
+      }
+    }
+
+    size_t len = 0;
+    switch (kField.radix) {
+      case Spec::Radix::Bin:
+        fmt.device.write("0b", 2);
+        len = to_bit_str(fmt.buf, field);
+        break;
+      case Spec::Radix::Oct:
+        fmt.device.write("0", field != 0);
+        len = to_oct_str(fmt.buf, field);
+        break;
+      case Spec::Radix::Hex:
+        fmt.device.write("0x", 2);
+        len = to_hex_str(fmt.buf, field);
+        break;
+      case Spec::Radix::Dec:
+      default:
+        len = to_str(fmt.buf, field);
+        break;
+    }
+    fmt.device.write(fmt.buf.data(), len);
+  }
+};
+}  // namespace reisfmt
@@ -0,0 +1,174 @@
+
+#pragma once
+#include <algorithm>
+#include <array>
+#include <ranges>
+#include <span>
+#include <tuple>
+#include <utility>
+#include <stdint.h>
+#include <stddef.h>
+
+#include "fmt.hh"
+
+namespace reisfmt {
+
+// A format string parsed once for rows of `Args`, so printing many rows doesn't parse the format and the specs of
+// every row again.
+template <typename... Args>
+class RowFormat {
+  struct Column {
+    StrIterator literal_{"", size_t(0)};
+    bool escaped_ = false;  // The literal has double braces.
+    bool used_    = false;  // Has a format guard.
+    Spec spec_;
+    StrIterator spec_str_{"", size_t(0)};  // Remaining spec, for formatters that parse their own.
+  };
+
+  // Counts the output, used to measure the columns.
+  struct Counter {
+    size_t size_ = 0;
+    void write(const char *, size_t n) { size_ += n; }
+  };
+
+  std::array<Column, sizeof...(Args)> columns_;
+  StrIterator tail_{"", size_t(0)};
+
+ public:
+  RowFormat(const char *fmt) {
+    StrIterator it = fmt ? StrIterator(fmt) : StrIterator("", size_t(0));
+    [&]<size_t... I>(std::index_sequence<I...>) {
+      (parse<Args>(it, columns_[I]), ...);
+    }(std::index_sequence_for<Args...>{});
+    tail_ = it;
+  }
+
+  // Widens the columns to fit the row.
+  void measure(Args... args) {
+    Counter counter;
+    Fmt<Counter> fmt(counter);
+    [&]<size_t... I>(std::index_sequence<I...>) {
+      (measure(fmt, columns_[I], args), ...);
+    }(std::index_sequence_for<Args...>{});
+  }
+
+  template <Writeable T>
+  void println(Fmt<T> &fmt, Args... args) {
+    [&]<size_t... I>(std::index_sequence<I...>) {
+      (print(fmt, columns_[I], args), ...);
+    }(std::index_sequence_for<Args...>{});
+    fmt.device.write(tail_.head_, tail_.size_);
+    fmt.device.write("\r\n", 2);
+  }
+
+ private:
+  template <typename U>
+  static void parse(StrIterator &it, Column &column) {
+    const char *start = it.head_;
+    while (it.size_ > 0) {
+      it.find('{');
+      if (it.size_ == 0 || it.peek() != '{') {
+        break;
+      }
+      // Double opening brace for scaping detected, skip one brace.
+      it.next();
+      column.escaped_ = true;
+    }
+
+    column.used_    = it.size_ > 0;
+    column.literal_ = StrIterator(start, it.head_ - int(column.used_));
+    if (column.used_) {
+      column.spec_.from_str(it, kAlignRight<std::remove_cv_t<U>>);
+      size_t size = 0;
+      while (size < it.size_ && it.head_[size] != '}') {
+        size++;
+      }
+      column.spec_str_ = StrIterator(it.head_, size);
+      it.find('}');
+    }
+  }
+
+  template <typename U>
+  static void measure(Fmt<Counter> &fmt, Column &column, U &value) {
+    // Types that can only be printed to a specific device can't be measured.
+    if constexpr (FormattableTo<Counter, U>) {
+      if (!column.used_) {
+        return;
+      }
+      fmt.device.size_ = 0;
+      fmt.spec         = column.spec_;
+      fmt.spec.width_  = 0;
+      StrIterator it   = column.spec_str_;
+      fmt.it_          = &it;
+      Formatter<Counter, U>::print(fmt, value);
+      column.spec_.width_ = std::max(column.spec_.width_, static_cast<int32_t>(fmt.device.size_));
+    }
+  }
+
+  template <Writeable T, typename U>
+  static void print(Fmt<T> &fmt, const Column &column, U &value) {
+    write_literal(fmt.device, column);
+    if (!column.used_) {
+      return;
+    }
+    fmt.spec       = column.spec_;
+    StrIterator it = column.spec_str_;
+    fmt.it_        = &it;
+    fmt.print_value(value);
+    fmt.it_ = nullptr;
+  }
+
+  template <Writeable T>
+  static inline void write_literal(T &device, const Column &column) {
+    if (!column.escaped_) {
+      device.write(column.literal_.head_, column.literal_.size_);
+      return;
+    }
+    StrIterator it = column.literal_;
+    while (it.size_ > 0) {
+      auto start = it.head_;
+      it.find('{');
+      device.write(start, it.head_ - start);
+      if (it.size_ > 0 && it.peek() == '{') {
+        it.next();
+      }
+    }
+  }
+};
+
+// Prints every row of `rows`, a range of tuples, pairs or arrays, as a line formatted by `format`.
+// With `auto_width` the columns are widened to fit the widest value, which takes an extra pass over the rows, so
+// `rows` must be a forward range.
+template <Writeable T, std::ranges::forward_range R>
+void print_table(Fmt<T> &fmt, const char *format, const R &rows, bool auto_width = false) {
+  using Row = std::ranges::range_value_t<R>;
+  auto row_format = []<size_t... I>(const char *format, std::index_sequence<I...>) {
+    return RowFormat<std::tuple_element_t<I, Row>...>(format);
+  }(format, std::make_index_sequence<std::tuple_size_v<Row>>{});
+
+  if (auto_width) {
+    for (const auto &row : rows) {
+      std::apply([&](auto... columns) { row_format.measure(columns...); }, row);
+    }
+  }
+  for (const auto &row : rows) {
+    std::apply([&](auto... columns) { row_format.println(fmt, columns...); }, row);
+  }
+}
+
+// Prints the columns `cols` side by side, one line per row. The rows are limited by the shortest column.
+template <Writeable T, typename... Cols, size_t... N>
+void print_columns(Fmt<T> &fmt, const char *format, bool auto_width, std::span<Cols, N>... cols) {
+  RowFormat<std::remove_cv_t<Cols>...> row_format(format);
+  size_t rows = std::min({cols.size()...});
+
+  if (auto_width) {
+    for (size_t i = 0; i < rows; ++i) {
+      row_format.measure(cols[i]...);
+    }
+  }
+  for (size_t i = 0; i < rows; ++i) {
+    row_format.println(fmt, cols[i]...);
+  }
+}
+}  // namespace reisfmt
@@ -46,6 +46,7 @@ struct Spec {
   char filler_                       = ' ';
   std::optional<StrIterator> prefix_ = std::nullopt;
   bool upper_case                    = false;
+  bool has_type_                     = false;
 
   void from_str(StrIterator &it, bool is_integral = true) {
     default_align_ = Align::Left;
@@ -107,7 +108,8 @@ struct Spec {
     bool force_prefix      = false;
     auto set_radix_and_prefix = [&](Radix radix, const char *str, size_t size) {
       upper_case = std::isupper(it.next().value());
-      radix_ = radix;
+      radix_     = radix;
+      has_type_  = true;
       // If the function `alternate mode`(#) is enabled.
       if (force_prefix || prefix_.has_value()) {
         prefix_ = std::optional{StrIterator{str, size}};
@@ -129,7 +131,8 @@ struct Spec {
       case 'd':
         radix_ = Radix::Dec;
         it.next();
-        prefix_ = std::nullopt;
+        prefix_   = std::nullopt;
+        has_type_ = true;
       default:
         break;
     }
@@ -142,6 +145,7 @@ struct Spec {
     filler_    = ' ';
     prefix_    = std::nullopt;
     upper_case = false;
+    has_type_  = false;
   }
 };
 };  // namespace reisfmt
@@ -1,11 +1,59 @@
 
 #pragma once
 #include <array>
+#include <concepts>
 #include <limits>
+#include <type_traits>
+#include <stdint.h>
 #include <stddef.h>
 
 namespace reisfmt {
 
+#ifdef __SIZEOF_INT128__
+// __int128 is only `std::integral` in the GNU dialects, so it's handled explicitly.
+template <typename U>
+concept Int128 = std::same_as<std::remove_cv_t<U>, __int128> || std::same_as<std::remove_cv_t<U>, unsigned __int128>;
+
+constexpr size_t kMaxIntegerBits = 128;
+#else
+template <typename U>
+concept Int128 = false;
+
+constexpr size_t kMaxIntegerBits = 64;
+#endif
+
+template <typename U>
+concept Integer = std::integral<U> || Int128<U>;
+
+template <Integer U>
+constexpr bool is_signed_integer() {
+  return static_cast<U>(-1) < static_cast<U>(0);
+}
+
+template <Integer U>
+struct Unsigned {
+  using type = std::make_unsigned_t<U>;
+};
+
+#ifdef __SIZEOF_INT128__
+template <Int128 U>
+struct Unsigned<U> {
+  using type = unsigned __int128;
+};
+#endif
+
+template <Integer U>
+using unsigned_t = typename Unsigned<U>::type;
+
+template <Integer U>
+constexpr U max_value() {
+  if constexpr (is_signed_integer<U>()) {
+    return static_cast<U>(static_cast<unsigned_t<U>>(~unsigned_t<U>(0)) >> 1);
+  } else {
+    return static_cast<U>(~U(0));
+  }
+}
+
 template <typename U>
 constexpr U decimal_digits(U number) {
   U digits = 0;
@@ -16,100 +64,139 @@ constexpr U decimal_digits(U number) {
   return digits;
 }
 
+// Writes the minus sign of negative numbers at `head` and returns the absolute value.
 template <size_t SIZE, typename U>
-  requires std::integral<U>
-inline size_t to_str(std::array<char, SIZE> &buf, U num) {
-  static_assert(SIZE >= decimal_digits(std::numeric_limits<U>::max()));
-  size_t head = 0;
-  size_t tail = SIZE - 1;
-  if constexpr (std::signed_integral<U>) {
+  requires Integer<U>
+inline unsigned_t<U> unsigned_abs(std::array<char, SIZE> &buf, size_t &head, U num) {
+  using V = unsigned_t<U>;
+  if constexpr (is_signed_integer<U>()) {
     // This code won't be linked for unsigned U.
     if (num < 0) {
       buf[head++] = '-';
-      num         = 0 - num;
+      return V(0) - static_cast<V>(num);
     }
   }
+  return static_cast<V>(num);
+}
 
-  do {
-    buf[tail--] = num % 10 + '0';
-    num /= 10;
-  } while (tail > 0 && num > 0);
-
+// Moves the digits written backwards from the end of the buffer to `head`. `tail` is one before the first digit, it
+// wraps around when the digits fill the buffer.
+template <size_t SIZE>
+inline size_t move_to_head(std::array<char, SIZE> &buf, size_t head, size_t tail) {
   tail++;
   size_t len = SIZE - tail + head;
-  for (size_t i = 0; i < len; ++i) {
-    buf[head + i] = buf[tail + i];
+  for (size_t i = head; i < len; ++i) {
+    buf[i] = buf[tail + i - head];
   }
-
   return len;
 }
 
 template <size_t SIZE, typename U>
-  requires std::integral<U>
+  requires Integer<U>
+inline size_t to_str(std::array<char, SIZE> &buf, U num) {
+  static_assert(SIZE >= decimal_digits(max_value<U>()) + is_signed_integer<U>(), "No room for the digits and the sign");
+  size_t head = 0;
+  size_t tail = SIZE - 1;
+  auto value  = unsigned_abs(buf, head, num);
+
+  if constexpr (sizeof(value) > sizeof(uint64_t)) {
+    // Peel 19 digits chunks with a single wide division each, the digits of every chunk are then produced with
+    // 64 bits arithmetic.
+    constexpr uint64_t kChunk       = 10'000'000'000'000'000'000ull;
+    constexpr size_t kDigitsInChunk = 19;
+    while (value >= kChunk) {
+      uint64_t chunk = static_cast<uint64_t>(value % kChunk);
+      value /= kChunk;
+      for (size_t i = 0; i < kDigitsInChunk; ++i) {
+        buf[tail--] = chunk % 10 + '0';
+        chunk /= 10;
+      }
+    }
+    uint64_t rest = static_cast<uint64_t>(value);
+    do {
+      buf[tail--] = rest % 10 + '0';
+      rest /= 10;
+    } while (rest > 0);
+  } else {
+    do {
+      buf[tail--] = value % 10 + '0';
+      value /= 10;
+    } while (value > 0);
+  }
+
+  return move_to_head(buf, head, tail);
+}
+
+template <size_t SIZE, typename U>
+  requires Integer<U>
+inline size_t to_oct_str(std::array<char, SIZE> &buf, U num) {
+  static_assert(SIZE >= (sizeof(U) * 8 + 2) / 3 + is_signed_integer<U>(), "No room for the digits and the sign");
+  size_t head = 0;
+  size_t tail = SIZE - 1;
+  auto value  = unsigned_abs(buf, head, num);
+
+  do {
+    buf[tail--] = (value & 0x7) + '0';
+    value >>= 3;
+  } while (value > 0);
+
+  return move_to_head(buf, head, tail);
+}
+
+template <size_t SIZE, typename U>
+  requires Integer<U>
 inline size_t to_hex_str(std::array<char, SIZE> &buf, U num, bool upper = false) {
   static_assert(SIZE >= sizeof(U) * 2);
-  constexpr U shift = (sizeof(U) * 8 - 4);
+  constexpr size_t shift = (sizeof(U) * 8 - 4);
 
   size_t head = 0;
-  if constexpr (std::signed_integral<U>) {
-    // This code won't be linked for unsigned U.
-    if (num < 0) {
-      buf[head++] = '-';
-      num         = 0 - num;
-    }
-  }
+  auto value  = unsigned_abs(buf, head, num);
 
   // Consume the leading zeros.
   size_t i = sizeof(U) * 2;
   for (; i > 1; --i) {
-    if (((num >> shift) & 0xf) > 0) {
+    if (((value >> shift) & 0xf) > 0) {
       break;
     }
-    num <<= 4;
+    value <<= 4;
   }
 
   const int conversion_factor = (upper ? 'A' : 'a') - 10;
 
   // Stringify the valid nibbles.
   for (; i > 0; --i) {
-    int masked = ((num >> shift) & 0xf);
+    int masked = ((value >> shift) & 0xf);
     if (masked < 0xa) {
       buf[head++] = masked + '0';
     } else {
       buf[head++] = conversion_factor + masked;
     }
-    num <<= 4;
+    value <<= 4;
   }
   return head;
 }
 
 template <size_t SIZE, typename U>
-  requires std::integral<U>
+  requires Integer<U>
 inline size_t to_bit_str(std::array<char, SIZE> &buf, U num) {
   static_assert(SIZE >= sizeof(U) * 8);
-  constexpr U shift = (sizeof(U) * 8 - 1);
+  constexpr size_t shift = (sizeof(U) * 8 - 1);
 
   size_t head = 0;
-  if constexpr (std::signed_integral<U>) {
-    // This code won't be linked for unsigned U.
-    if (num < 0) {
-      buf[head++] = '-';
-      num         = 0 - num;
-    }
-  }
+  auto value  = unsigned_abs(buf, head, num);
 
   // Consume the leading zeros.
   size_t i = sizeof(U) * 8;
   for (; i > 1; --i) {
-    if (((num >> shift) & 0x1)) {
+    if (((value >> shift) & 0x1)) {
       break;
     }
-    num <<= 1;
+    value <<= 1;
   }
   // Stringify the valid bits.
   for (; i > 0; --i) {
-    buf[head++] = ((num >> shift) & 0x1) + '0';
-    num <<= 1;
+    buf[head++] = ((value >> shift) & 0x1) + '0';
+    value <<= 1;
   }
   return head;
 }
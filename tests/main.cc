@@ -6,6 +6,12 @@
 
 #include "fmt.hh"
 #include "fmt_collections.hh"
+#include "fmt_record.hh"
+#include "fmt_chrono.hh"
+#include "fmt_compress.hh"
+#include "fmt_table.hh"
+#include "fmt_register.hh"
+#include "fmt_dedup.hh"
 
 struct IostreamMock {
   std::vector<char> buf_;
@@ -366,6 +372,537 @@ TEST_F(FmtTest, print_vector) {
   EXPECT_EQ(mock_.to_string(), "dump: [ 0xa1, 0x5c, 0x49,]\r\n");
 }
 
+TEST_F(FmtTest, json_record) {
+  fmt_.println("{}", reisfmt::json(reisfmt::Field{"level", "info"}, reisfmt::Field{"id", -42}, reisfmt::Field{"ok", true},
+                                    reisfmt::Field{"ptr", nullptr}, reisfmt::Field{"name", std::string("dev0")}));
+  EXPECT_EQ(mock_.to_string(), "{\"level\":\"info\",\"id\":-42,\"ok\":true,\"ptr\":null,\"name\":\"dev0\"}\r\n");
+}
+
+TEST_F(FmtTest, json_escape) {
+  fmt_.print("{}", reisfmt::json(reisfmt::Field{"msg", "say \"hi\"\\\n\tnow\x01 end of a long clean run"}));
+  EXPECT_EQ(mock_.to_string(), "{\"msg\":\"say \\\"hi\\\"\\\\\\n\\tnow\\u0001 end of a long clean run\"}");
+}
+
+TEST_F(FmtTest, json_escape_differential) {
+  auto naive = [](const std::string &str) {
+    std::string res;
+    for (unsigned char c : str) {
+      switch (c) {
+        case '"':
+          res += "\\\"";
+          break;
+        case '\\':
+          res += "\\\\";
+          break;
+        case '\n':
+          res += "\\n";
+          break;
+        case '\r':
+          res += "\\r";
+          break;
+        case '\t':
+          res += "\\t";
+          break;
+        case '\b':
+          res += "\\b";
+          break;
+        case '\f':
+          res += "\\f";
+          break;
+        default:
+          res += c < 0x20 ? std::format("\\u{:04x}", c) : std::string(1, c);
+          break;
+      }
+    }
+    return res;
+  };
+
+  std::string text;
+  for (int i = 0; i < 300; i++) {
+    text += static_cast<char>((i * 37) % 256);
+    fmt_.print("{}", reisfmt::json(reisfmt::Field{"k", text}));
+    EXPECT_EQ(mock_.to_string(), "{\"k\":\"" + naive(text) + "\"}");
+  }
+}
+
+TEST_F(FmtTest, logfmt_record) {
+  fmt_.println("{}", reisfmt::logfmt(reisfmt::Field{"level", "warn"}, reisfmt::Field{"msg", "disk full"},
+                                      reisfmt::Field{"code", 28u}, reisfmt::Field{"path", ""}));
+  EXPECT_EQ(mock_.to_string(), "level=warn msg=\"disk full\" code=28 path=\"\"\r\n");
+}
+
+TEST_F(FmtTest, record_ignores_outer_spec) {
+  fmt_.print("{:x}", reisfmt::logfmt(reisfmt::Field{"n", 255}, reisfmt::Field{"mem", Memory{0x10, 4}}));
+  EXPECT_EQ(mock_.to_string(), "n=255 mem=\"PRINTABLE -> Memory: addr: 0x10, size: 4\"");
+}
+
+TEST_F(FmtTest, chrono_duration) {
+  using namespace std::chrono_literals;
+  fmt_.print("{} {} {} {:%T} {:%H:%M:%S} {:>12%T}|", 42ms, 7s, -3us, 3723500ms, 3723s, 61s);
+  EXPECT_EQ(mock_.to_string(), "42ms 7s -3us 01:02:03.500 01:02:03     00:01:01|");
+}
+
+TEST_F(FmtTest, chrono_time_point) {
+  using namespace std::chrono;
+  sys_time<milliseconds> tp = sys_days{year{2024} / 2 / 29} + 13h + 45min + 7s + 89ms;
+  fmt_.print("{} [{:%Y/%m/%d %H:%M}] {:%T %% %Q%q}", tp, tp, tp);
+  EXPECT_EQ(mock_.to_string(), "2024-02-29 13:45:07.089 [2024/02/29 13:45] 13:45:07.089 % 1709214307s");
+
+  fmt_.print("{}", sys_days{year{1969} / 12 / 31} + 23h + 59min + 59s + 999ms);
+  EXPECT_EQ(mock_.to_string(), "1969-12-31 23:59:59.999");
+}
+
+TEST_F(FmtTest, chrono_time_point_cached) {
+  using namespace std::chrono;
+  constexpr const char *msg                  = "[{:%T|%S}] tick";
+  sys_time<microseconds> tp                  = sys_days{year{2023} / 1 / 1} + 23h + 59min + 58s;
+  const std::array<int, 6> steps             = {0, 1, 999'998, 1, 3, 1'000'000};
+  const std::array<const char *, 6> expected = {
+      "[23:59:58.000000|58.000000] tick", "[23:59:58.000001|58.000001] tick",
+      "[23:59:58.999999|58.999999] tick", "[23:59:59.000000|59.000000] tick",
+      "[23:59:59.000003|59.000003] tick", "[00:00:00.000003|00.000003] tick",
+  };
+  for (size_t i = 0; i < steps.size(); ++i) {
+    tp += microseconds{steps[i]};
+    fmt_.print(msg, tp);
+    EXPECT_EQ(mock_.to_string(), expected[i]);
+  }
+  fmt_.print("{:%F}", tp);
+  EXPECT_EQ(mock_.to_string(), "2023-01-02");
+}
+
+TEST_F(FmtTest, chrono_time_point_many_fractions) {
+  using namespace std::chrono;
+  sys_time<milliseconds> tp = sys_days{year{2024} / 2 / 29} + 13h + 45min;
+  for (auto expected : {"00.00000.00000.00000.00000.000", "00.00500.00500.00500.00500.005"}) {
+    fmt_.print("{:%S%S%S%S%S}", tp);
+    EXPECT_EQ(mock_.to_string(), expected);
+    tp += 5ms;
+  }
+}
+
+TEST_F(FmtTest, chrono_time_point_cache_spec_change) {
+  using namespace std::chrono;
+  sys_time<milliseconds> tp = sys_days{year{2024} / 2 / 29} + 13h + 45min + 7s;
+  char msg[16];
+  for (auto [spec, expected] : {std::pair{"{:%H:%M}", "13:45"}, std::pair{"{:%Y/%m}", "2024/02"},
+                                std::pair{"{:%Y/%m}", "2024/02"}, std::pair{"{:%H:%M}", "13:45"}}) {
+    std::strcpy(msg, spec);
+    fmt_.print(msg, tp);
+    EXPECT_EQ(mock_.to_string(), expected);
+    tp += 1ms;
+  }
+}
+
+enum class State : uint8_t { Idle, Running, Stopped = 5 };
+enum Color { Red, Green, Blue };
+namespace hw {
+enum class Errno : int { Timeout = -2, Busy = -1, Ok = 0 };
+}
+template <>
+struct reisfmt::EnumTraits<hw::Errno> {
+  static constexpr std::array<std::pair<hw::Errno, const char *>, 3> names = {
+      {{hw::Errno::Timeout, "ETIMEDOUT"}, {hw::Errno::Busy, "EBUSY"}, {hw::Errno::Ok, "OK"}}};
+};
+
+TEST_F(FmtTest, enum_names) {
+  fmt_.print("{} {} {} {} {}", State::Idle, State::Running, State::Stopped, Green, Blue);
+  EXPECT_EQ(mock_.to_string(), "Idle Running Stopped Green Blue");
+}
+
+TEST_F(FmtTest, enum_unnamed_value) {
+  fmt_.print("{} {}", static_cast<State>(3), static_cast<State>(200));
+  EXPECT_EQ(mock_.to_string(), "3 200");
+}
+
+TEST_F(FmtTest, enum_integer_spec) {
+  fmt_.print("{:d} {:#x} {:>10} {:*<8}|", State::Stopped, State::Stopped, State::Running, Red);
+  EXPECT_EQ(mock_.to_string(), "5 0x5    Running Red*****|");
+}
+
+TEST_F(FmtTest, enum_name_table) {
+  fmt_.print("{} {} {} {} {:d}", hw::Errno::Timeout, hw::Errno::Busy, hw::Errno::Ok, static_cast<hw::Errno>(-3),
+             hw::Errno::Timeout);
+  EXPECT_EQ(mock_.to_string(), "ETIMEDOUT EBUSY OK -3 -2");
+}
+
+enum class Big : uint64_t { A = 0, B = 1ull << 32, C = ~0ull };
+TEST_F(FmtTest, enum_wide_values) {
+  fmt_.print("{} {} {}", Big::A, Big::B, Big::C);
+  EXPECT_EQ(mock_.to_string(), "A 4294967296 18446744073709551615");
+}
+
+struct Quoted {
+  int n;
+  template <typename T>
+  inline void print(reisfmt::Fmt<T> &fmt) {
+    fmt.print("say \"{}\"", n);
+  }
+};
+TEST_F(FmtTest, record_other_values_as_strings) {
+  using namespace std::chrono_literals;
+  using reisfmt::Field;
+  fmt_.print("{}", reisfmt::json(Field{"state", State::Running}, Field{"t", 42ms}, Field{"m", Quoted{3}}));
+  EXPECT_EQ(mock_.to_string(), "{\"state\":\"Running\",\"t\":\"42ms\",\"m\":\"say \\\"3\\\"\"}");
+  fmt_.print("{}", reisfmt::logfmt(Field{"state", State::Running}, Field{"t", 42ms}, Field{"m", Quoted{3}}));
+  EXPECT_EQ(mock_.to_string(), "state=Running t=42ms m=\"say \\\"3\\\"\"");
+}
+
+TEST_F(FmtTest, octal) {
+  constexpr const char *msg = "{:o} {:#o} {:o} {:o} {:06o}";
+  for (int i = 0; i < 10; i++) {
+    int a            = -7 * i;
+    unsigned b       = 0x9f3 * i;
+    int64_t c        = std::numeric_limits<int64_t>::min() / (i + 1);
+    uint64_t d       = std::numeric_limits<uint64_t>::max() / (i + 1);
+    unsigned short e = 9 * i;
+    fmt_.print(msg, a, b, c, d, e);
+    EXPECT_EQ(mock_.to_string(), std::format(msg, a, b, c, d, e));
+  }
+}
+
+#ifdef __SIZEOF_INT128__
+// Reference conversion: one 128 bits division per digit.
+template <typename U>
+std::string reference_int128(U num, unsigned radix) {
+  std::string res;
+  bool negative         = num < 0;
+  unsigned __int128 mag = negative ? 0 - static_cast<unsigned __int128>(num) : static_cast<unsigned __int128>(num);
+  do {
+    res.insert(res.begin(), "0123456789abcdef"[static_cast<int>(mag % radix)]);
+    mag /= radix;
+  } while (mag);
+  return negative ? "-" + res : res;
+}
+
+TEST_F(FmtTest, int128_differential) {
+  using u128               = unsigned __int128;
+  using i128               = __int128;
+  std::vector<u128> values = {0, 1, 9, 10, 10'000'000'000'000'000'000ull, 10'000'000'000'000'000'000ull - 1,
+                              std::numeric_limits<uint64_t>::max(), static_cast<u128>(1) << 64, ~u128(0),
+                              ~u128(0) >> 1, (~u128(0) >> 1) + 1};
+  u128 seed = 0x9e3779b97f4a7c15ull;
+  for (int i = 0; i < 200; i++) {
+    seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+    values.push_back(seed >> (i % 128));
+  }
+
+  for (u128 u : values) {
+    i128 s = static_cast<i128>(u);
+    fmt_.print("{} {:x} {:b} {:o}", u, u, u, u);
+    EXPECT_EQ(mock_.to_string(), reference_int128(u, 10) + " " + reference_int128(u, 16) + " " +
+                                     reference_int128(u, 2) + " " + reference_int128(u, 8));
+    fmt_.print("{} {:x} {:b} {:o}", s, s, s, s);
+    EXPECT_EQ(mock_.to_string(), reference_int128(s, 10) + " " + reference_int128(s, 16) + " " +
+                                     reference_int128(s, 2) + " " + reference_int128(s, 8));
+  }
+}
+
+TEST_F(FmtTest, to_str_exact_buffer) {
+  std::array<char, 10> u32;
+  EXPECT_EQ(std::string(u32.data(), reisfmt::to_str(u32, 4294967295u)), "4294967295");
+  std::array<char, 11> i32;
+  EXPECT_EQ(std::string(i32.data(), reisfmt::to_str(i32, std::numeric_limits<int32_t>::min())), "-2147483648");
+  std::array<char, 20> u64;
+  EXPECT_EQ(std::string(u64.data(), reisfmt::to_str(u64, std::numeric_limits<uint64_t>::max())),
+            "18446744073709551615");
+  std::array<char, 11> oct;
+  EXPECT_EQ(std::string(oct.data(), reisfmt::to_oct_str(oct, 4294967295u)), "37777777777");
+  std::array<char, 39> u128;
+  EXPECT_EQ(std::string(u128.data(), reisfmt::to_str(u128, ~static_cast<unsigned __int128>(0))),
+            "340282366920938463463374607431768211455");
+}
+
+TEST_F(FmtTest, int128_spec) {
+  unsigned __int128 a = static_cast<unsigned __int128>(0xdeadbeef) << 64;
+  fmt_.print("{:#x} {:*>45} {:<3}|", a, a, static_cast<__int128>(-1));
+  EXPECT_EQ(mock_.to_string(), "0xdeadbeef0000000000000000 ****************68915718005535514953299001344 -1 |");
+}
+#endif
+
+TEST_F(FmtTest, compress_round_trip) {
+  constexpr std::string_view dictionary = "[{}] channel {} rx={} tx={} status={}\nlink up on port {}\n";
+  IostreamMock wire;
+  reisfmt::Compressor<IostreamMock, 256> compressor(wire, dictionary);
+  reisfmt::Fmt<reisfmt::Compressor<IostreamMock, 256>> fmt(compressor);
+
+  std::string expected;
+  for (int i = 0; i < 200; i++) {
+    fmt.println("[{}] channel {} rx={} tx={} status={}", i * 10, i % 4, i * 1000, i * 7, i % 3 ? "OK" : "RETRY");
+    expected += std::format("[{}] channel {} rx={} tx={} status={}\r\n", i * 10, i % 4, i * 1000, i * 7,
+                            i % 3 ? "OK" : "RETRY");
+    if (i % 50 == 0) {
+      // Lines longer than the window and the literal runs.
+      std::string noise;
+      for (int j = 0; j < 600; j++) {
+        noise += static_cast<char>(' ' + (j * 7919 + i) % 95);
+      }
+      fmt.print("{}", noise);
+      expected += noise;
+    }
+  }
+  compressor.flush();
+  std::string encoded = wire.to_string();
+  EXPECT_LT(encoded.size(), expected.size() / 2);
+
+  // Feed the decoder with odd sized chunks.
+  reisfmt::Decompressor<IostreamMock> decompressor(mock_, dictionary);
+  for (size_t pos = 0; pos < encoded.size(); pos += 7) {
+    decompressor.write(encoded.data() + pos, std::min<size_t>(7, encoded.size() - pos));
+  }
+  EXPECT_EQ(mock_.to_string(), expected);
+}
+
+TEST_F(FmtTest, compress_dictionary_outlives_window) {
+  constexpr std::string_view dictionary = "link up on port {} speed {} duplex {}\n";
+  std::string noise;
+  for (int j = 0; j < 1000; j++) {
+    noise += static_cast<char>(' ' + (j * 7919) % 95);
+  }
+
+  // Returns the stream and the size of the last line, written once the noise has filled the window.
+  auto encode = [&](std::string_view dictionary) {
+    IostreamMock wire;
+    reisfmt::Compressor<IostreamMock, 256> compressor(wire, dictionary);
+    reisfmt::Fmt<reisfmt::Compressor<IostreamMock, 256>> fmt(compressor);
+    fmt.println("{}", noise);
+    size_t before = wire.buf_.size();
+    fmt.println("link up on port {} speed {} duplex {}", 3, 1000, "full");
+    size_t line = wire.buf_.size() - before;
+    return std::pair{wire.to_string(), line};
+  };
+  auto [plain, plain_line]   = encode("");
+  auto [primed, primed_line] = encode(dictionary);
+  EXPECT_LT(primed_line * 2, plain_line);
+
+  reisfmt::Decompressor<IostreamMock> decompressor(mock_, dictionary);
+  decompressor.write(primed.data(), primed.size());
+  EXPECT_EQ(mock_.to_string(), noise + "\r\nlink up on port 3 speed 1000 duplex full\r\n");
+}
+
+TEST_F(FmtTest, compress_flush_on_new_line) {
+  IostreamMock wire;
+  reisfmt::Compressor<IostreamMock> compressor(wire);
+  reisfmt::Fmt<reisfmt::Compressor<IostreamMock>> fmt(compressor);
+  fmt.print("no new line");
+  EXPECT_TRUE(wire.buf_.empty());
+  fmt.println(" yet");
+  reisfmt::Decompressor<IostreamMock> decompressor(mock_);
+  std::string encoded = wire.to_string();
+  decompressor.write(encoded.data(), encoded.size());
+  EXPECT_EQ(mock_.to_string(), "no new line yet\r\n");
+}
+
+TEST_F(FmtTest, table_matches_println) {
+  constexpr const char *msg = "{:<10}|{:>8}|{:#06x}|{:^7}|{{ {} }";
+  std::vector<std::tuple<const char *, int, unsigned, bool, State>> rows;
+  std::string expected;
+  for (int i = 0; i < 20; i++) {
+    rows.emplace_back(i % 2 ? "odd" : "even", i * -37, i * 0x51, i % 3 == 0, static_cast<State>(i % 3));
+    auto [a, b, c, d, e] = rows.back();
+    fmt_.println(msg, a, b, c, d, e);
+    expected += mock_.to_string();
+  }
+  reisfmt::print_table(fmt_, msg, rows);
+  EXPECT_EQ(mock_.to_string(), expected);
+}
+
+TEST_F(FmtTest, table_auto_width) {
+  const std::vector<std::pair<const char *, uint32_t>> rows = {{"rx", 12}, {"tx_dropped", 7}, {"crc", 123456}};
+  reisfmt::print_table(fmt_, "{:<4}: {:>} ;", rows, true);
+  EXPECT_EQ(mock_.to_string(), "rx        :     12 ;\r\ntx_dropped:      7 ;\r\ncrc       : 123456 ;\r\n");
+}
+
+TEST_F(FmtTest, table_columns) {
+  const std::array<uint32_t, 3> addr = {0x1000'0000, 0x2000'0000, 0x4000'0000};
+  const std::vector<size_t> size     = {256 * 1024, 64 * 1024, 4096, 8};
+  const std::array<Memory, 3> mem    = {Memory{1, 2}, Memory{3, 4}, Memory{5, 6}};
+  reisfmt::print_columns(fmt_, "{:#x} {:>6} {}", false, std::span{addr}, std::span{size}, std::span{mem});
+  EXPECT_EQ(mock_.to_string(),
+            "0x10000000 262144 PRINTABLE -> Memory: addr: 0x1, size: 2\r\n"
+            "0x20000000  65536 PRINTABLE -> Memory: addr: 0x3, size: 4\r\n"
+            "0x40000000   4096 PRINTABLE -> Memory: addr: 0x5, size: 6\r\n");
+}
+
+TEST_F(FmtTest, table_missing_and_excess_args) {
+  const std::vector<std::tuple<int, int>> rows = {{1, 2}};
+  reisfmt::print_table(fmt_, "{} * {} = {}", rows);
+  reisfmt::print_table(fmt_, "only {}", rows);
+  reisfmt::print_table(fmt_, "none", rows);
+  EXPECT_EQ(mock_.to_string(), "1 * 2 = {}\r\nonly 1\r\nnone\r\n");
+}
+
+TEST_F(FmtTest, table_chrono_column) {
+  using namespace std::chrono;
+  const std::vector<std::tuple<milliseconds, int>> rows = {{3723500ms, 1}, {61s, 2}};
+  reisfmt::print_table(fmt_, "{:%T} {}", rows);
+  EXPECT_EQ(mock_.to_string(), "01:02:03.500 1\r\n00:01:01.000 2\r\n");
+}
+
+constexpr std::array<const char *, 3> kModeNames = {"IDLE", "RUN", nullptr};
+struct Ctrl {
+  static constexpr const char *name                        = "CTRL";
+  static constexpr std::array<reisfmt::BitField, 4> fields = {{
+      {"EN", 0, 1},
+      {"MODE", 1, 2, kModeNames},
+      {"DIV", 4, 8, {}, reisfmt::Spec::Radix::Hex},
+      {"IRQ", 15, 1},
+  }};
+};
+
+template <typename U>
+concept RegisterType = requires { typename reisfmt::Register<Ctrl, U>; };
+TEST_F(FmtTest, register_fields) {
+  fmt_.println("{}", reisfmt::Register<Ctrl>{0x8001});
+  EXPECT_EQ(mock_.to_string(), "CTRL=0x8001 {EN=1, MODE=IDLE, DIV=0x0, IRQ=1}\r\n");
+
+  fmt_.print("{} {}", reisfmt::Register<Ctrl>{0x0a53}, reisfmt::Register<Ctrl>{0x0ffe});
+  EXPECT_EQ(mock_.to_string(),
+            "CTRL=0xa53 {EN=1, MODE=RUN, DIV=0xa5, IRQ=0} CTRL=0xffe {EN=0, MODE=3, DIV=0xff, IRQ=0}");
+
+  // Signed registers would print a negative hex value and extract the fields from an arithmetic shift.
+  static_assert(!RegisterType<int32_t> && RegisterType<uint16_t>);
+}
+
+struct Status64 {
+  static constexpr const char *name                        = "STATUS";
+  static constexpr std::array<reisfmt::BitField, 2> fields = {{
+      {"LO", 0, 32, {}, reisfmt::Spec::Radix::Bin},
+      {"ALL", 0, 64},
+  }};
+};
+
+TEST_F(FmtTest, register_full_width_fields) {
+  fmt_.print("{}", reisfmt::Register<Status64, uint64_t>{0xffff'ffff'0000'0005});
+  EXPECT_EQ(mock_.to_string(), "STATUS=0xffffffff00000005 {LO=0b101, ALL=18446744069414584325}");
+}
+
+struct FakeClock {
+  using duration   = std::chrono::milliseconds;
+  using time_point = std::chrono::time_point<FakeClock, duration>;
+  static inline time_point now_{};
+  static time_point now() { return now_; }
+};
+
+class DedupTest : public testing::Test {
+ public:
+  IostreamMock mock_ = IostreamMock();
+  reisfmt::Dedup<IostreamMock, 32, FakeClock> dedup_;
+  reisfmt::Fmt<reisfmt::Dedup<IostreamMock, 32, FakeClock>> fmt_;
+
+  DedupTest() : dedup_(mock_, std::chrono::milliseconds(100)), fmt_(dedup_) { FakeClock::now_ = {}; }
+};
+
+TEST_F(DedupTest, collapse_repeated_lines) {
+  for (int i = 0; i < 5; i++) {
+    fmt_.println("error {}: {}", 42, "timeout");
+  }
+  fmt_.println("error {}: {}", 43, "timeout");
+  fmt_.println("error {}: {}", 43, "timeout");
+  fmt_.println("recovered");
+  EXPECT_EQ(mock_.to_string(),
+            "error 42: timeout\r\nprevious message repeated 4 times\r\n"
+            "error 43: timeout\r\nprevious message repeated 1 time\r\nrecovered\r\n");
+}
+
+TEST_F(DedupTest, timeout) {
+  fmt_.println("link down");
+  for (int i = 0; i < 7; i++) {
+    FakeClock::now_ += std::chrono::milliseconds(30);
+    fmt_.println("link down");
+  }
+  EXPECT_EQ(mock_.to_string(), "link down\r\nprevious message repeated 5 times\r\n");
+
+  FakeClock::now_ += std::chrono::milliseconds(69);
+  dedup_.poll();
+  EXPECT_EQ(mock_.to_string(), "");
+  FakeClock::now_ += std::chrono::milliseconds(1);
+  dedup_.poll();
+  EXPECT_EQ(mock_.to_string(), "previous message repeated 2 times\r\n");
+}
+
+TEST_F(DedupTest, long_and_partial_lines) {
+  const std::string long_line(40, '*');
+  fmt_.println("{}", long_line.c_str());
+  fmt_.println("{}", long_line.c_str());
+  EXPECT_EQ(mock_.to_string(), long_line + "\r\n" + long_line + "\r\n");
+
+  fmt_.print("partial ");
+  EXPECT_EQ(mock_.to_string(), "");
+  dedup_.flush();
+  EXPECT_EQ(mock_.to_string(), "partial ");
+  fmt_.println("line");
+  EXPECT_EQ(mock_.to_string(), "line\r\n");
+  fmt_.println("partial line");
+  fmt_.println("other");
+  EXPECT_EQ(mock_.to_string(), "previous message repeated 1 time\r\nother\r\n");
+}
+
+TEST_F(FmtTest, width_printable) {
+  fmt_.print("[{:>50}] [{:*<50}] [{:-^50}]", Memory{0x10, 4}, Memory{0x10, 4}, Memory{0x10, 4});
+  EXPECT_EQ(mock_.to_string(),
+            "[          PRINTABLE -> Memory: addr: 0x10, size: 4] [PRINTABLE -> Memory: addr: 0x10, size: 4**********] "
+            "[-----PRINTABLE -> Memory: addr: 0x10, size: 4-----]");
+}
+
+TEST_F(FmtTest, width_formatter_extended_types) {
+  fmt_.print("{:>50}|{:20}|", Circle{10, -1, 8}, Circle{1, 2, 3});
+  EXPECT_EQ(mock_.to_string(),
+            "     FORMATTER -> Circle: posx: -1, posy: 8, r: 10|FORMATTER -> Circle: posx: 2, posy: 3, r: 1|");
+}
+
+TEST_F(FmtTest, width_larger_than_buffer) {
+  std::vector<int> arr(40, 0xab);
+  std::string content = "[";
+  for (int i = 0; i < 40; i++) {
+    content += " 0xab,";
+  }
+  content += "]\r\n";
+  for (auto [msg, fill] : {std::pair{"{:.>300}", std::string(300 - content.size(), '.') + content},
+                           std::pair{"{:.<300}", content + std::string(300 - content.size(), '.')},
+                           std::pair{"{:.^301}", std::string(28, '.') + content + std::string(29, '.')},
+                           std::pair{"{:10}", content}}) {
+    fmt_.print(msg, arr);
+    EXPECT_EQ(mock_.to_string(), fill);
+  }
+}
+
+TEST_F(FmtTest, width_char_and_bool) {
+  constexpr const char *msg = "{:>3}|{:<6}|{:^7}|{:3}|{:6}|";
+  fmt_.print(msg, 'c', true, false, 'c', true);
+  EXPECT_EQ(mock_.to_string(), std::format(msg, 'c', true, false, 'c', true));
+}
+
+// Printable and Formatter for a single device.
+struct MockRegister {
+  uint32_t addr;
+  int value;
+  void print(reisfmt::Fmt<IostreamMock> &fmt) { fmt.print("REG {:#x} {}", addr, value); }
+};
+struct MockPin {
+  int pin;
+};
+template <>
+struct reisfmt::Formatter<IostreamMock, MockPin> {
+  static inline void print(Fmt<IostreamMock> &fmt, MockPin &obj) { fmt.print("PIN{}", obj.pin); }
+};
+TEST_F(FmtTest, width_device_specific_types) {
+  fmt_.print("{} {:>12} {} {:6}|", MockRegister{5, 2}, MockRegister{5, 2}, MockPin{3}, MockPin{4});
+  EXPECT_EQ(mock_.to_string(), "REG 0x5 2 REG 0x5 2 PIN3 PIN4|");
+
+  const std::vector<std::tuple<MockRegister, int>> rows = {{MockRegister{1, 2}, 1}};
+  reisfmt::print_table(fmt_, "{} {:>3}", rows, true);
+  EXPECT_EQ(mock_.to_string(), "REG 0x1 2   1\r\n");
+}
+
+TEST_F(FmtTest, width_in_table) {
+  const std::vector<std::tuple<Memory, int>> rows = {{Memory{1, 2}, 1}, {Memory{0x100, 4096}, 2}};
+  reisfmt::print_table(fmt_, "{:<} {}", rows, true);
+  EXPECT_EQ(mock_.to_string(),
+            "PRINTABLE -> Memory: addr: 0x1, size: 2      1\r\n"
+            "PRINTABLE -> Memory: addr: 0x100, size: 4096 2\r\n");
+}
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
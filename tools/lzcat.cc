@@ -0,0 +1,33 @@
+// Host side decoder for the stream produced by `reisfmt::Compressor`.
+// Usage: reisfmt_lzcat [dictionary.txt] < capture.bin
+// The dictionary file must hold the same bytes as the dictionary given to the compressor.
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+
+#include "fmt_compress.hh"
+
+struct Stdout {
+  void write(const char *buf, size_t n) { fwrite(buf, 1, n, stdout); }
+};
+
+int main(int argc, char **argv) {
+  std::string dictionary;
+  if (argc > 1) {
+    std::ifstream file(argv[1], std::ios::binary);
+    if (!file) {
+      fprintf(stderr, "Could not open %s\n", argv[1]);
+      return 1;
+    }
+    dictionary.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  }
+
+  Stdout out;
+  reisfmt::Decompressor<Stdout> decompressor(out, dictionary);
+  std::array<char, 4096> buf;
+  while (size_t n = fread(buf.data(), 1, buf.size(), stdin)) {
+    decompressor.write(buf.data(), n);
+  }
+  return 0;
+}